@@ -16,6 +16,8 @@
 #define RMW_CONNEXT_CPP__CONNEXT_STATIC_PUBLISHER_INFO_HPP_
 
 #include <atomic>
+#include <mutex>
+#include <vector>
 
 #include "rmw_connext_shared_cpp/ndds_include.hpp"
 #include "rmw_connext_shared_cpp/types.hpp"
@@ -29,16 +31,80 @@
 #include "rmw/types.h"
 #include "rmw/ret_types.h"
 
+class ConflatingPublisher;
 class ConnextPublisherListener;
+class DeferredPublishQueue;
+class ConnextStaticSerializedData;
+class ConnextStaticSerializedDataDataWriter;
 
 struct ConnextStaticPublisherInfo : ConnextCustomEventInfo
 {
   DDS::Publisher * dds_publisher_;
   ConnextPublisherListener * listener_;
   DDS::DataWriter * topic_writer_;
+  /// topic_writer_ narrowed once at creation time.
+  ConnextStaticSerializedDataDataWriter * data_writer_;
+  /// Sample reused for every write, guarded by publish_mutex_.
+  /**
+   * Its serialized_data never owns memory, it only ever loans the buffer being published.
+   */
+  ConnextStaticSerializedData * instance_;
   const message_type_support_callbacks_t * callbacks_;
   rmw_gid_t publisher_gid;
 
+  /// Drop messages while the listener reports no matched subscription.
+  bool skip_when_unmatched_;
+  std::atomic<uint64_t> skipped_unmatched_;
+
+  /// Upper bound on the capacity of cdr_stream_ kept between two publishes.
+  /**
+   * Larger messages are still published, but the buffer grown for them is released afterwards
+   * so that a single large message does not pin its memory for the lifetime of the publisher.
+   */
+  static constexpr size_t max_cached_cdr_stream_capacity = 1024 * 1024;
+
+  /// Serialization buffer reused across calls to rmw_publish(), guarded by publish_mutex_.
+  rcutils_uint8_array_t cdr_stream_;
+  /// Buffer publish_serialized_message_fragments() gathers into, guarded by publish_mutex_.
+  /**
+   * Unlike cdr_stream_ it keeps the size of the largest gathered message, fragmented messages
+   * tend to be large and would otherwise reallocate the buffer for every publish.
+   */
+  rcutils_uint8_array_t gather_buffer_;
+  std::mutex publish_mutex_;
+
+  /// Queue written by a dedicated thread, null if messages are written on the caller's thread.
+  DeferredPublishQueue * deferred_queue_;
+  /// Writer of the latest message only, null if every message is written.
+  ConflatingPublisher * conflating_publisher_;
+
+  /// Pool of messages handed out by rmw_borrow_loaned_message(), null if loaning is disabled.
+  /**
+   * Only set up for plain message types, whose memory layout is fully described by the type code.
+   * Holds loan_pool_size_ messages of loan_message_size_ bytes each.
+   */
+  uint8_t * loan_pool_;
+  size_t loan_pool_size_;
+  size_t loan_message_size_;
+  /// Messages of the pool not currently loaned, guarded by loan_mutex_.
+  std::vector<void *> loan_free_;
+  std::mutex loan_mutex_;
+
+  /// Hand out a zero initialized message from the loan pool.
+  /**
+   * \return the message or nullptr if all messages of the pool are loaned
+   */
+  void * borrow_loaned_message();
+
+  /// Return true if the message points into the loan pool.
+  bool is_in_loan_pool(const void * message) const;
+
+  /// Give a message handed out by borrow_loaned_message() back to the pool.
+  /**
+   * \return false if the message isn't currently loaned from this publisher
+   */
+  bool return_loaned_message(void * message);
+
   /**
    * Remap the specific RTI Connext DDS DataWriter Status to a generic RMW status type.
    *
@@ -54,6 +120,26 @@ struct ConnextStaticPublisherInfo : ConnextCustomEventInfo
   DDS::Entity * get_entity() override;
 };
 
+/// Resources preallocated by rmw_init_publisher_allocation() for a single message type.
+/**
+ * The serialization buffer is sized for the largest serialized sample and the allocator of
+ * cdr_stream_ refuses to hand out any more memory, so the CDR stream is never reallocated.
+ * Publishing is not allocation free though: to_cdr_stream() of the type support still creates
+ * and deletes a temporary DDS sample for every message it serializes.
+ * An allocation must not be used by multiple threads concurrently.
+ */
+struct ConnextStaticPublisherAllocation
+{
+  const message_type_support_callbacks_t * callbacks_;
+  ConnextStaticSerializedData * instance_;
+  uint8_t * buffer_;
+  size_t buffer_capacity_;
+  /// View onto buffer_ passed to the type support, reset before every publish.
+  rcutils_uint8_array_t cdr_stream_;
+  /// Set by the allocator of cdr_stream_ when the type support tried to grow the buffer.
+  bool exhausted_;
+};
+
 class ConnextPublisherListener : public DDS::PublisherListener
 {
 public:
@@ -70,7 +156,7 @@ public:
   }
 
 private:
-  std::atomic<std::size_t> current_count_;
+  std::atomic<std::size_t> current_count_{0};
 };
 
 #endif  // RMW_CONNEXT_CPP__CONNEXT_STATIC_PUBLISHER_INFO_HPP_
@@ -16,6 +16,7 @@
 #define RMW_CONNEXT_CPP__CONNEXT_STATIC_SERVICE_INFO_HPP_
 
 #include "rmw_connext_shared_cpp/ndds_include.hpp"
+#include "rmw_connext_shared_cpp/wait_notifier.hpp"
 
 #include "rosidl_typesupport_connext_cpp/service_type_support.h"
 
@@ -26,7 +27,15 @@ struct ConnextStaticServiceInfo
   void * replier_;
   DDS::DataReader * request_datareader_;
   DDS::ReadCondition * read_condition_;
+  /// Notified whenever a request arrives, for epoll wait sets.
+  ConnextWaitNotifier * wait_notifier_;
   const service_type_support_callbacks_t * callbacks_;
+
+  /// Return the notifier to wait on with epoll.
+  ConnextWaitNotifier * get_wait_notifier()
+  {
+    return wait_notifier_;
+  }
 };
 }  // extern "C"
 
@@ -16,10 +16,15 @@
 #define RMW_CONNEXT_CPP__CONNEXT_STATIC_SUBSCRIBER_INFO_HPP_
 
 #include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include "rmw_connext_shared_cpp/ndds_include.hpp"
 #include "rmw_connext_shared_cpp/connext_static_event_info.hpp"
 #include "rmw_connext_shared_cpp/types.hpp"
+#include "rmw_connext_shared_cpp/wait_notifier.hpp"
 
 #include "ndds/ndds_cpp.h"
 #include "ndds/ndds_namespace_cpp.h"
@@ -28,13 +33,32 @@
 #include "rmw/types.h"
 #include "rmw/ret_types.h"
 
+class ConnextStaticSerializedDataSeq;
 class ConnextSubscriberListener;
+class SubscriptionPushQueue;
+
+/// A sample kept loaned from the data reader while the caller uses its serialized data.
+struct ConnextStaticSerializedLoan
+{
+  ConnextStaticSerializedDataSeq * dds_messages_;
+  DDS::SampleInfoSeq * sample_infos_;
+  /// Serialized data of the loaned sample, which identifies the loan when it is returned.
+  const uint8_t * buffer_;
+};
 
 struct ConnextStaticSubscriberInfo : ConnextCustomEventInfo
 {
   DDS::Subscriber * dds_subscriber_;
   ConnextSubscriberListener * listener_;
   DDS::DataReader * topic_reader_;
+  /// Topic filtering the messages of the reader, null if the subscription has no filter.
+  DDS::ContentFilteredTopic * content_filtered_topic_;
+  /// Queue the reader's listener pushes samples into, null if messages are taken from DDS.
+  SubscriptionPushQueue * push_queue_;
+  /// Condition the subscription is waited for with, triggered while data can be taken.
+  DDS::Condition * wait_condition_;
+  /// Notified whenever data arrives, for epoll wait sets.
+  ConnextWaitNotifier * wait_notifier_;
   DDS::ReadCondition * read_condition_;
   const message_type_support_callbacks_t * callbacks_;
   /// Remap the specific RTI Connext DDS DataReader Status to a generic RMW status type.
@@ -48,6 +72,68 @@ struct ConnextStaticSubscriberInfo : ConnextCustomEventInfo
    * \return the topic reader associated with this subscriber
    */
   DDS::Entity * get_entity() override;
+  /// Return the condition to wait on for data.
+  DDS::Condition * get_wait_condition()
+  {
+    return wait_condition_;
+  }
+  /// Return the notifier to wait on for data with epoll.
+  ConnextWaitNotifier * get_wait_notifier()
+  {
+    return wait_notifier_;
+  }
+
+  /// Samples handed out by take_serialized_message_loan().
+  /**
+   * Along with serialized_loans_free_ it has room for every loan record ever allocated,
+   * so that moving a record between the two never allocates.
+   */
+  std::vector<ConnextStaticSerializedLoan *> serialized_loans_;
+  /// Loan records not currently in use, kept to be reused by later takes.
+  std::vector<ConnextStaticSerializedLoan *> serialized_loans_free_;
+  /// Number of loan records allocated so far.
+  size_t serialized_loan_count_;
+  /// Guards serialized_loans_, serialized_loans_free_ and serialized_loan_count_.
+  std::mutex serialized_loans_mutex_;
+
+  /// Get an unused loan record, reusing one if available.
+  /**
+   * Room for a new record in both lists is reserved here, so neither
+   * add_serialized_loan() nor release_serialized_loan() ever allocate.
+   *
+   * \return the loan record or nullptr if it could not be allocated
+   */
+  ConnextStaticSerializedLoan * acquire_serialized_loan();
+  /// Give a loan record whose sample has been returned to the reader back for reuse.
+  void release_serialized_loan(ConnextStaticSerializedLoan * loan);
+  /// Remember the loan of a taken sample until remove_serialized_loan() is called.
+  void add_serialized_loan(const uint8_t * buffer, ConnextStaticSerializedLoan * loan);
+  /// Forget the loan of the sample owning the given serialized data.
+  /**
+   * \return the loan record or nullptr if the data isn't loaned from this subscription
+   */
+  ConnextStaticSerializedLoan * remove_serialized_loan(const uint8_t * buffer);
+  /// Return all outstanding loans to the reader and free all loan records.
+  /**
+   * Has to be called before the reader is deleted.
+   */
+  rmw_ret_t return_serialized_loans();
+};
+
+/// Resources kept by rmw_init_subscription_allocation() for a single message type.
+/**
+ * Only holds the empty sequences the sample and its info are loaned into, taken samples are
+ * converted straight from the reader's loan.
+ * This does not make taking allocation free: to_message() of the type support still creates
+ * and deletes a temporary DDS sample for every message it converts, and the ROS message may
+ * allocate memory for its strings and sequences.
+ * An allocation must not be used by multiple threads concurrently.
+ */
+struct ConnextStaticSubscriptionAllocation
+{
+  const message_type_support_callbacks_t * callbacks_;
+  ConnextStaticSerializedDataSeq * dds_messages_;
+  DDS::SampleInfoSeq * sample_infos_;
 };
 
 class ConnextSubscriberListener : public DDS::SubscriberListener
@@ -65,6 +151,11 @@ public:
     return current_count_;
   }
 
+  /// Name of the DDS topic of the reader.
+  std::string topic_name_;
+  /// Whether the reader was registered to have local writers ignored by the participant.
+  bool ignore_local_writers_in_participant_ = false;
+
 private:
   std::atomic<std::size_t> current_count_;
 };
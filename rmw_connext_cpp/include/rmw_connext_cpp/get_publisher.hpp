@@ -15,6 +15,8 @@
 #ifndef RMW_CONNEXT_CPP__GET_PUBLISHER_HPP_
 #define RMW_CONNEXT_CPP__GET_PUBLISHER_HPP_
 
+#include <cstdint>
+
 #include "rmw_connext_shared_cpp/ndds_include.hpp"
 #include "rmw/rmw.h"
 #include "rmw_connext_cpp/visibility_control.h"
@@ -33,6 +35,31 @@ RMW_CONNEXT_CPP_PUBLIC
 DDS::DataWriter *
 get_data_writer(rmw_publisher_t * publisher);
 
+/// Counters of a publisher, accumulated since its creation.
+struct PublisherStatistics
+{
+  /// Messages dropped because no subscription was matched, see PublisherOptions.
+  uint64_t skipped_unmatched;
+  /// Messages currently waiting in the deferred publish queue.
+  uint64_t deferred_queue_depth;
+  /// Messages dropped because the deferred publish queue was full.
+  uint64_t deferred_dropped;
+  /// Messages replaced by a newer one before being written, see conflation_interval.
+  uint64_t conflated;
+};
+
+/// Retrieve the statistics of a publisher.
+/**
+ * \param publisher the publisher to inspect
+ * \param[out] statistics the current counters of the publisher
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is null, or
+ * \return `RMW_RET_ERROR` if the publisher is from another rmw implementation
+ */
+RMW_CONNEXT_CPP_PUBLIC
+rmw_ret_t
+get_publisher_statistics(const rmw_publisher_t * publisher, PublisherStatistics * statistics);
+
 }  // namespace rmw_connext_cpp
 
 #endif  // RMW_CONNEXT_CPP__GET_PUBLISHER_HPP_
@@ -0,0 +1,80 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_CONNEXT_CPP__PUBLISH_HPP_
+#define RMW_CONNEXT_CPP__PUBLISH_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rmw/rmw.h"
+
+#include "rmw_connext_cpp/visibility_control.h"
+
+namespace rmw_connext_cpp
+{
+
+/// Send all messages the publisher has batched so far.
+/**
+ * Blocks until the deferred publish queue of the publisher, if it has one, wrote every
+ * message queued before the call, and until a message pending in the conflation was
+ * written without waiting for the conflation interval.
+ * Sending the batch afterwards only has an effect on publishers created with
+ * `PublisherOptions::batch_enable`.
+ *
+ * \param publisher the publisher to flush
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if the publisher is null, or
+ * \return `RMW_RET_ERROR` if an unexpected error occurs
+ */
+RMW_CONNEXT_CPP_PUBLIC
+rmw_ret_t
+flush_publisher(const rmw_publisher_t * publisher);
+
+/// A piece of a serialized message.
+struct SerializedMessageFragment
+{
+  const uint8_t * buffer;
+  size_t length;
+};
+
+/// Publish a serialized message which is split into several fragments.
+/**
+ * The fragments are published as a single sample holding their concatenation,
+ * the first fragment has to start with the CDR encapsulation header.
+ * Like any other message, the sample goes through the conflation or the deferred
+ * publish queue of the publisher, if it has one, and the fragments are gathered
+ * straight into its buffer.
+ * Otherwise they are gathered into a buffer of the publisher, which keeps the size of
+ * the largest message gathered so far, unless there is only a single fragment.
+ * Either way the message is copied once, rather than concatenated by the caller first.
+ *
+ * \param publisher the publisher to publish with
+ * \param fragments array of fragments in the order they are concatenated
+ * \param fragment_count number of elements in `fragments`
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is null or empty, or
+ * \return `RMW_RET_BAD_ALLOC` if the buffer gathering the fragments can't grow, or
+ * \return `RMW_RET_ERROR` if an unexpected error occurs
+ */
+RMW_CONNEXT_CPP_PUBLIC
+rmw_ret_t
+publish_serialized_message_fragments(
+  const rmw_publisher_t * publisher,
+  const SerializedMessageFragment * fragments,
+  size_t fragment_count);
+
+}  // namespace rmw_connext_cpp
+
+#endif  // RMW_CONNEXT_CPP__PUBLISH_HPP_
@@ -0,0 +1,138 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_CONNEXT_CPP__PUBLISHER_OPTIONS_HPP_
+#define RMW_CONNEXT_CPP__PUBLISHER_OPTIONS_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rmw/types.h"
+
+#include "rmw_connext_cpp/visibility_control.h"
+
+namespace rmw_connext_cpp
+{
+
+/// How a publisher hands messages to the network.
+enum class PublishMode
+{
+  /// Synchronous if the largest serialized message fits into a single datagram,
+  /// asynchronous for larger and unbounded message types.
+  automatic,
+  /// Send from within the publish call, avoiding the latency of a thread hand-off.
+  synchronous,
+  /// Send from a separate thread, paced by the default flow controller.
+  asynchronous
+};
+
+/// What a publisher with a deferred publish queue does when the queue is full.
+enum class OverflowPolicy
+{
+  /// Replace the oldest queued message with the new one.
+  drop_oldest,
+  /// Drop the new message.
+  drop_newest,
+  /// Block the publishing thread until the writer thread freed a slot.
+  block
+};
+
+/// Connext specific options of a publisher.
+/**
+ * Pass a pointer to an instance as `rmw_specific_publisher_payload` of the
+ * `rmw_publisher_options_t` given to `rmw_create_publisher()`.
+ * The instance is only read during the call.
+ * Publishers created without a payload use get_default_publisher_options().
+ * A default constructed instance equals those defaults with none of their
+ * environment variables set.
+ */
+struct PublisherOptions
+{
+  /// Drop messages without serializing them while no subscription is matched.
+  /**
+   * Only honored for publishers with volatile durability, since late joiners of
+   * any other durability expect to receive messages published before they matched.
+   * Skipped messages are counted in PublisherStatistics::skipped_unmatched.
+   */
+  bool skip_when_unmatched = false;
+
+  /// Number of messages preallocated for rmw_borrow_loaned_message(), 0 disables loaning.
+  /**
+   * Disabled by default, since the pool is allocated whether or not messages are borrowed.
+   * Loaning is only available for plain message types, which contain neither strings nor
+   * sequences, and serializes the message straight from the loaned memory.
+   * Loaned messages are zero initialized rather than set to the default values of the type.
+   */
+  size_t loan_pool_size = 0;
+
+  /// Number of messages queued for a dedicated writer thread, 0 writes on the caller's thread.
+  /**
+   * With a queue, publishing only serializes the message into a preallocated slot,
+   * the write happens later on a thread owned by the publisher.
+   * Messages are written in order, pending ones are written when the publisher is destroyed.
+   * Publishing with a publisher allocation bypasses the queue.
+   */
+  size_t deferred_queue_depth = 0;
+  /// Behavior of a full deferred publish queue, drops are counted in PublisherStatistics.
+  OverflowPolicy deferred_overflow_policy = OverflowPolicy::drop_oldest;
+
+  /// Only write the latest message, at most once per interval, zero writes every message.
+  /**
+   * Messages published within the interval replace each other, a timer thread owned by the
+   * publisher writes the latest one once the interval since the previous write has passed.
+   * Replaced messages are counted in PublisherStatistics::conflated.
+   * Can't be combined with a deferred publish queue and is bypassed by publisher allocations.
+   */
+  rmw_time_t conflation_interval = {0, 0};
+
+  /// Publish mode of the data writer, batching requires it to be synchronous or automatic.
+  PublishMode publish_mode = PublishMode::automatic;
+
+  /// Let the data writer combine consecutive messages into a single network packet.
+  /**
+   * Pending messages are sent once one of the batch limits below is reached,
+   * or explicitly with flush_publisher().
+   * This trades latency, bounded by batch_max_flush_delay, for fewer packets
+   * when publishing many small messages.
+   */
+  bool batch_enable = false;
+  /// Maximum number of messages in a batch, 0 for unlimited.
+  int32_t batch_max_samples = 0;
+  /// Maximum number of serialized bytes in a batch, 0 for the Connext default of 1024.
+  int32_t batch_max_bytes = 0;
+  /// Maximum time a message waits in a batch, zero for no limit.
+  rmw_time_t batch_max_flush_delay = {0, 1000000};
+};
+
+/// Return the options used for publishers created without a payload.
+/**
+ * Every option is disabled unless enabled by one of these environment variables:
+ *
+ * - `RMW_CONNEXT_PUBLISHER_SKIP_WHEN_UNMATCHED=1` enables `skip_when_unmatched`
+ * - `RMW_CONNEXT_PUBLISHER_BATCHING=1` enables `batch_enable`
+ * - `RMW_CONNEXT_PUBLISH_MODE=synchronous|asynchronous` overrides `publish_mode`,
+ *   which is `automatic` otherwise
+ *
+ * With batching enabled a message waits at most one millisecond in a batch by default.
+ * Loaning is opt-in, `loan_pool_size` is 0 by default.
+ *
+ * \return the default publisher options
+ */
+RMW_CONNEXT_CPP_PUBLIC
+PublisherOptions
+get_default_publisher_options();
+
+}  // namespace rmw_connext_cpp
+
+#endif  // RMW_CONNEXT_CPP__PUBLISHER_OPTIONS_HPP_
@@ -0,0 +1,127 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_CONNEXT_CPP__SUBSCRIPTION_OPTIONS_HPP_
+#define RMW_CONNEXT_CPP__SUBSCRIPTION_OPTIONS_HPP_
+
+#include <cstddef>
+
+#include "rmw/rmw.h"
+
+#include "rmw_connext_cpp/visibility_control.h"
+
+namespace rmw_connext_cpp
+{
+
+/// Connext specific options of a subscription.
+/**
+ * Pass a pointer to an instance as `rmw_specific_subscription_payload` of the
+ * `rmw_subscription_options_t` given to `rmw_create_subscription()`.
+ * The instance is only read during the call.
+ * Subscriptions created without a payload use get_default_subscription_options(),
+ * which equals a default constructed instance.
+ */
+struct SubscriptionOptions
+{
+  /// SQL filter expression on the fields of the message, null or empty to receive every message.
+  /**
+   * The reader is created on a content filtered topic, which lets matched writers
+   * evaluate the filter and not send messages the subscription doesn't want at all.
+   * Parameters are referred to as `%0`, `%1`, ... in the expression.
+   */
+  const char * filter_expression = nullptr;
+  /// Initial values of the parameters of the filter expression.
+  const char * const * filter_parameters = nullptr;
+  /// Number of filter parameters, at most 100.
+  size_t filter_parameters_count = 0;
+
+  /// Minimum time between delivered messages, zero to deliver every message.
+  /**
+   * Downsamples the topic in the middleware: messages arriving sooner than this after the
+   * previously delivered one are dropped by the reader, or not even sent by the writer.
+   * Must not be longer than the deadline of the qos profile.
+   */
+  rmw_time_t minimum_separation = {0, 0};
+
+  /// Number of messages queued by the reader's listener as they arrive, 0 to disable.
+  /**
+   * The listener takes every sample on the DDS receive thread and copies it into one
+   * of this many preallocated buffers, replacing the oldest one when all are queued.
+   * Waiting for the subscription then uses a single guard condition, and taking a message
+   * only deserializes a queued buffer without calling into DDS.
+   * Serialized loans aren't available with a queue.
+   */
+  size_t push_queue_depth = 0;
+
+  /// Have the node's participant ignore the local writers of the topic, false by default.
+  /**
+   * Only honored together with `ignore_local_publications`, which otherwise drops the
+   * samples of the node's own writers after receiving them.
+   * Ignored writers are never delivered to the participant at all, which saves
+   * receiving the samples in the first place, but applies to the whole node:
+   * once ignored, a writer stays ignored for every subscription of the node,
+   * including ones created later which want local publications.
+   * Writers are only ignored while no subscription of the node on the topic wants them.
+   */
+  bool ignore_local_writers_in_participant = false;
+};
+
+/// Return the options used for subscriptions created without a payload.
+/**
+ * \return the default subscription options, which don't filter any messages
+ */
+RMW_CONNEXT_CPP_PUBLIC
+SubscriptionOptions
+get_default_subscription_options();
+
+/// Return the minimum separation in effect for a subscription.
+/**
+ * Complements rmw_subscription_get_actual_qos(), whose profile can't express it.
+ *
+ * \param subscription the subscription to query
+ * \param[out] minimum_separation the minimum time between delivered messages,
+ *   zero if every message is delivered
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is null, or
+ * \return `RMW_RET_ERROR` if an unexpected error occurs
+ */
+RMW_CONNEXT_CPP_PUBLIC
+rmw_ret_t
+get_subscription_minimum_separation(
+  const rmw_subscription_t * subscription,
+  rmw_time_t * minimum_separation);
+
+/// Replace the parameters of the filter expression of a subscription.
+/**
+ * Takes effect for subsequently received messages without recreating the reader,
+ * matched writers are informed about the new parameters.
+ *
+ * \param subscription the subscription created with a filter expression
+ * \param filter_parameters the new values of the parameters
+ * \param filter_parameters_count the number of parameters, at most 100
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if the subscription is null, has no filter
+ *   expression or the parameters don't fit the expression, or
+ * \return `RMW_RET_ERROR` if an unexpected error occurs
+ */
+RMW_CONNEXT_CPP_PUBLIC
+rmw_ret_t
+set_subscription_filter_parameters(
+  const rmw_subscription_t * subscription,
+  const char * const * filter_parameters,
+  size_t filter_parameters_count);
+
+}  // namespace rmw_connext_cpp
+
+#endif  // RMW_CONNEXT_CPP__SUBSCRIPTION_OPTIONS_HPP_
@@ -0,0 +1,161 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_CONNEXT_CPP__TAKE_HPP_
+#define RMW_CONNEXT_CPP__TAKE_HPP_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rmw/rmw.h"
+
+#include "rmw_connext_cpp/visibility_control.h"
+
+namespace rmw_connext_cpp
+{
+
+/// Message info extended by the metadata DDS keeps for every sample.
+struct ExtendedMessageInfo
+{
+  /// The info filled by rmw_take_with_info().
+  rmw_message_info_t message_info;
+  /// Time the message has been published at, in nanoseconds since the epoch.
+  int64_t source_timestamp;
+  /// Time the message has been received at, in nanoseconds since the epoch.
+  /**
+   * Together with the source timestamp this gives the latency of the message,
+   * as far as the clocks of both hosts are synchronized.
+   */
+  int64_t received_timestamp;
+  /// Sequence number of the message among those written by its publisher.
+  /**
+   * Increases by one per message, so a gap between consecutive messages of the same
+   * publisher means messages have been lost, filtered or replaced in the history.
+   */
+  uint64_t publication_sequence_number;
+};
+
+/// Take a message like rmw_take_with_info(), filling the extended message info.
+/**
+ * \param subscription the subscription to take from
+ * \param ros_message the initialized message to take into
+ * \param[out] taken true if a message was taken
+ * \param[out] message_info the info of the taken message
+ * \param allocation a subscription allocation or null
+ * \return `RMW_RET_OK` if successful, including when no message was available, or
+ * \return `RMW_RET_ERROR` if an argument is null or an unexpected error occurs
+ */
+RMW_CONNEXT_CPP_PUBLIC
+rmw_ret_t
+take_with_extended_info(
+  const rmw_subscription_t * subscription,
+  void * ros_message,
+  bool * taken,
+  ExtendedMessageInfo * message_info,
+  rmw_subscription_allocation_t * allocation);
+
+/// Take a serialized message, filling the extended message info.
+/**
+ * Behaves like rmw_take_serialized_message_with_info() otherwise.
+ *
+ * \param subscription the subscription to take from
+ * \param serialized_message the serialized message to copy into
+ * \param[out] taken true if a message was taken
+ * \param[out] message_info the info of the taken message
+ * \param allocation a subscription allocation or null
+ * \return `RMW_RET_OK` if successful, including when no message was available, or
+ * \return `RMW_RET_BAD_ALLOC` if the buffer of the serialized message could not be grown, or
+ * \return `RMW_RET_ERROR` if an argument is null or an unexpected error occurs
+ */
+RMW_CONNEXT_CPP_PUBLIC
+rmw_ret_t
+take_serialized_message_with_extended_info(
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message,
+  bool * taken,
+  ExtendedMessageInfo * message_info,
+  rmw_subscription_allocation_t * allocation);
+
+/// Take up to `count` messages with a single call into the data reader.
+/**
+ * Draining a backlog this way costs one DDS take and loan instead of one per message.
+ * Samples without data and, if requested by the subscription options, samples of
+ * local publications are skipped, so fewer messages than available may be taken.
+ *
+ * \param subscription the subscription to take from
+ * \param count the maximum number of messages to take
+ * \param ros_messages array of `count` initialized messages to take into
+ * \param[out] message_infos array of `count` message infos filled in parallel to
+ *   `ros_messages`, may be null
+ * \param[out] taken the number of messages taken
+ * \param allocation a subscription allocation or null
+ * \return `RMW_RET_OK` if successful, including when no message was available, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is null or `count` is 0, or
+ * \return `RMW_RET_ERROR` if an unexpected error occurs
+ */
+RMW_CONNEXT_CPP_PUBLIC
+rmw_ret_t
+take_sequence(
+  const rmw_subscription_t * subscription,
+  size_t count,
+  void * const * ros_messages,
+  rmw_message_info_t * message_infos,
+  size_t * taken,
+  rmw_subscription_allocation_t * allocation);
+
+/// Take a serialized message without copying it out of the data reader.
+/**
+ * The serialized message is pointed at the serialized data of the sample, which stays
+ * loaned from the reader until return_serialized_message_loan() is called with it.
+ * The message doesn't own its buffer and must not be finalized or resized by the caller.
+ * Outstanding loans count against the resource limits of the reader, so they should
+ * be returned promptly; loans still held when the subscription is destroyed are returned.
+ *
+ * \param subscription the subscription to take from
+ * \param[out] serialized_message the view onto the loaned serialized data
+ * \param[out] taken true if a message was taken
+ * \param[out] message_info the info of the taken message, may be null
+ * \return `RMW_RET_OK` if successful, including when no message was available, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is null, or
+ * \return `RMW_RET_BAD_ALLOC` if the loan could not be tracked, or
+ * \return `RMW_RET_ERROR` if an unexpected error occurs
+ */
+RMW_CONNEXT_CPP_PUBLIC
+rmw_ret_t
+take_serialized_message_loan(
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message,
+  bool * taken,
+  rmw_message_info_t * message_info);
+
+/// Return a serialized message taken with take_serialized_message_loan() to the reader.
+/**
+ * The serialized message is zero initialized afterwards.
+ *
+ * \param subscription the subscription the message has been taken from
+ * \param serialized_message the loaned serialized message
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if an argument is null or the message isn't loaned
+ *   from this subscription, or
+ * \return `RMW_RET_ERROR` if an unexpected error occurs
+ */
+RMW_CONNEXT_CPP_PUBLIC
+rmw_ret_t
+return_serialized_message_loan(
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message);
+
+}  // namespace rmw_connext_cpp
+
+#endif  // RMW_CONNEXT_CPP__TAKE_HPP_
@@ -0,0 +1,57 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef RMW_CONNEXT_CPP__WAIT_SET_OPTIONS_HPP_
+#define RMW_CONNEXT_CPP__WAIT_SET_OPTIONS_HPP_
+
+#include "rmw/rmw.h"
+
+#include "rmw_connext_cpp/visibility_control.h"
+
+namespace rmw_connext_cpp
+{
+
+/// Mechanism a wait set blocks with.
+enum class WaitSetBackend
+{
+  /// The DDS wait set, attaching a condition of every entity waited on.
+  dds,
+  /// An epoll instance on Linux, polling a descriptor notified by every entity waited on.
+  /**
+   * Waking up doesn't go through the DDS wait set, whose wait also gathers
+   * every active condition. Waits on events, or on entities of a type support
+   * without notifiers, still use the DDS wait set.
+   */
+  epoll
+};
+
+/// Select the mechanism a wait set blocks with, the DDS wait set by default.
+/**
+ * Must not be called while another thread waits on the wait set.
+ *
+ * \param wait_set the wait set to configure
+ * \param backend the mechanism to block with
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_INVALID_ARGUMENT` if the wait set is null, or
+ * \return `RMW_RET_UNSUPPORTED` if the backend isn't available on this platform, or
+ * \return `RMW_RET_ERROR` if an unexpected error occurs
+ */
+RMW_CONNEXT_CPP_PUBLIC
+rmw_ret_t
+set_wait_set_backend(rmw_wait_set_t * wait_set, WaitSetBackend backend);
+
+}  // namespace rmw_connext_cpp
+
+#endif  // RMW_CONNEXT_CPP__WAIT_SET_OPTIONS_HPP_
@@ -0,0 +1,84 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+
+#include "bounded_index_queue.hpp"
+
+BoundedIndexQueue::BoundedIndexQueue(size_t capacity)
+: mask_(0), enqueue_position_(0), dequeue_position_(0)
+{
+  size_t size = 1;
+  while (size < capacity) {
+    size <<= 1;
+  }
+  cells_.reset(new Cell[size]);
+  for (size_t i = 0; i < size; ++i) {
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+  }
+  mask_ = size - 1;
+}
+
+bool
+BoundedIndexQueue::push(size_t index)
+{
+  size_t position = enqueue_position_.load(std::memory_order_relaxed);
+  Cell * cell;
+  while (true) {
+    cell = &cells_[position & mask_];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+    if (difference == 0) {
+      if (enqueue_position_.compare_exchange_weak(
+          position, position + 1, std::memory_order_relaxed))
+      {
+        break;
+      }
+    } else if (difference < 0) {
+      return false;
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+  cell->index = index;
+  cell->sequence.store(position + 1, std::memory_order_release);
+  return true;
+}
+
+bool
+BoundedIndexQueue::pop(size_t & index)
+{
+  size_t position = dequeue_position_.load(std::memory_order_relaxed);
+  Cell * cell;
+  while (true) {
+    cell = &cells_[position & mask_];
+    const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+    const intptr_t difference =
+      static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position + 1);
+    if (difference == 0) {
+      if (dequeue_position_.compare_exchange_weak(
+          position, position + 1, std::memory_order_relaxed))
+      {
+        break;
+      }
+    } else if (difference < 0) {
+      return false;
+    } else {
+      position = dequeue_position_.load(std::memory_order_relaxed);
+    }
+  }
+  index = cell->index;
+  cell->sequence.store(position + mask_ + 1, std::memory_order_release);
+  return true;
+}
@@ -0,0 +1,52 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef BOUNDED_INDEX_QUEUE_HPP_
+#define BOUNDED_INDEX_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/// Bounded lock-free queue of slot indices, safe for multiple producers and consumers.
+/**
+ * Every cell carries a sequence number telling whether it is ready to be written
+ * or read in the current lap around the ring.
+ */
+class BoundedIndexQueue
+{
+public:
+  /// Create a queue holding at least `capacity` indices.
+  explicit BoundedIndexQueue(size_t capacity);
+
+  /// Append an index, return false if the queue is full.
+  bool push(size_t index);
+
+  /// Remove the oldest index, return false if the queue is empty.
+  bool pop(size_t & index);
+
+private:
+  struct Cell
+  {
+    std::atomic<size_t> sequence;
+    size_t index;
+  };
+
+  std::unique_ptr<Cell[]> cells_;
+  size_t mask_;
+  std::atomic<size_t> enqueue_position_;
+  std::atomic<size_t> dequeue_position_;
+};
+
+#endif  // BOUNDED_INDEX_QUEUE_HPP_
@@ -0,0 +1,223 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <system_error>
+#include <utility>
+
+#include "rcutils/logging_macros.h"
+
+#include "rmw/error_handling.h"
+
+#include "conflating_publisher.hpp"
+#include "publish_helpers.hpp"
+
+// include patched generated code from the build folder
+#include "connext_static_serialized_dataSupport.h"
+
+ConflatingPublisher::ConflatingPublisher(
+  ConnextStaticSerializedDataDataWriter * data_writer,
+  std::chrono::nanoseconds interval)
+: data_writer_(data_writer),
+  instance_(nullptr),
+  interval_(interval),
+  latest_(rcutils_get_zero_initialized_uint8_array()),
+  writing_(rcutils_get_zero_initialized_uint8_array()),
+  pending_(false),
+  flush_requested_(false),
+  write_in_progress_(false),
+  stop_(false),
+  conflated_(0)
+{
+  latest_.allocator = rcutils_get_default_allocator();
+  writing_.allocator = rcutils_get_default_allocator();
+}
+
+ConflatingPublisher::~ConflatingPublisher()
+{
+  stop();
+  for (rcutils_uint8_array_t * buffer : {&latest_, &writing_}) {
+    if (buffer->buffer) {
+      buffer->allocator.deallocate(buffer->buffer, buffer->allocator.state);
+    }
+  }
+  if (instance_) {
+    ConnextStaticSerializedDataTypeSupport::delete_data(instance_);
+  }
+}
+
+bool
+ConflatingPublisher::start()
+{
+  instance_ = ConnextStaticSerializedDataTypeSupport::create_data();
+  if (!instance_) {
+    RMW_SET_ERROR_MSG("failed to create dds message instance");
+    return false;
+  }
+  // The sample only ever loans the buffer being written.
+  if (!instance_->serialized_data.maximum(0)) {
+    RMW_SET_ERROR_MSG("failed to release memory of dds message instance");
+    return false;
+  }
+  try {
+    thread_ = std::thread(&ConflatingPublisher::run, this);
+  } catch (const std::system_error &) {
+    RMW_SET_ERROR_MSG("failed to start the timer thread of the conflating publisher");
+    return false;
+  }
+  return true;
+}
+
+void
+ConflatingPublisher::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  flushed_cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+rmw_ret_t
+ConflatingPublisher::push(
+  const message_type_support_callbacks_t * callbacks,
+  const void * ros_message)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!latest_.buffer) {
+    latest_.buffer_capacity = 0;
+  }
+  latest_.buffer_length = 0;
+  if (!callbacks->to_cdr_stream(ros_message, &latest_)) {
+    // the previous message is gone as well, so there is nothing left to write
+    discard_locked();
+    RMW_SET_ERROR_MSG("failed to convert ros_message to cdr stream");
+    return RMW_RET_ERROR;
+  }
+  // to_cdr_stream() reallocates the buffer when it is too small, but does not
+  // update the capacity accordingly.
+  if (latest_.buffer_capacity < latest_.buffer_length) {
+    latest_.buffer_capacity = latest_.buffer_length;
+  }
+  if (!latest_.buffer || latest_.buffer_length == 0) {
+    discard_locked();
+    RMW_SET_ERROR_MSG("no serialized message attached");
+    return RMW_RET_ERROR;
+  }
+  commit_locked();
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+ConflatingPublisher::push_serialized(const rcutils_uint8_array_t * serialized_message)
+{
+  if (!serialized_message->buffer || serialized_message->buffer_length == 0) {
+    RMW_SET_ERROR_MSG("no serialized message attached");
+    return RMW_RET_ERROR;
+  }
+  rmw_connext_cpp::SerializedMessageFragment fragment;
+  fragment.buffer = serialized_message->buffer;
+  fragment.length = serialized_message->buffer_length;
+  return push_fragments(&fragment, 1, fragment.length);
+}
+
+rmw_ret_t
+ConflatingPublisher::push_fragments(
+  const rmw_connext_cpp::SerializedMessageFragment * fragments,
+  size_t fragment_count,
+  size_t total_length)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  rmw_ret_t ret = gather_fragments(fragments, fragment_count, total_length, &latest_);
+  if (ret != RMW_RET_OK) {
+    // the previous message is gone as well, so there is nothing left to write
+    discard_locked();
+    return ret;
+  }
+  commit_locked();
+  return RMW_RET_OK;
+}
+
+void
+ConflatingPublisher::flush()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (pending_) {
+    flush_requested_ = true;
+    cv_.notify_one();
+  }
+  flushed_cv_.wait(lock, [this]() {return stop_ || (!pending_ && !write_in_progress_);});
+}
+
+uint64_t
+ConflatingPublisher::conflated() const
+{
+  return conflated_;
+}
+
+void
+ConflatingPublisher::commit_locked()
+{
+  if (pending_) {
+    ++conflated_;
+  } else {
+    pending_ = true;
+    cv_.notify_one();
+  }
+}
+
+void
+ConflatingPublisher::discard_locked()
+{
+  pending_ = false;
+  flush_requested_ = false;
+  flushed_cv_.notify_all();
+}
+
+void
+ConflatingPublisher::run()
+{
+  // Allow the first message to be written immediately.
+  auto next_write = std::chrono::steady_clock::now();
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() {return pending_ || stop_;});
+    if (!stop_) {
+      // Keep collecting newer messages until the interval has passed or a flush is requested.
+      cv_.wait_until(lock, next_write, [this]() {return stop_ || flush_requested_;});
+    }
+    if (pending_) {
+      // Swapping keeps the capacity of both buffers, so neither needs to grow again.
+      std::swap(latest_, writing_);
+      pending_ = false;
+      flush_requested_ = false;
+      write_in_progress_ = true;
+      lock.unlock();
+      if (!publish(data_writer_, instance_, &writing_)) {
+        RCUTILS_LOG_ERROR_NAMED(
+          "rmw_connext_cpp", "failed to write message of the conflating publisher");
+      }
+      next_write = std::chrono::steady_clock::now() + interval_;
+      lock.lock();
+      write_in_progress_ = false;
+      flushed_cv_.notify_all();
+    }
+    if (stop_ && !pending_) {
+      break;
+    }
+  }
+}
@@ -0,0 +1,121 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CONFLATING_PUBLISHER_HPP_
+#define CONFLATING_PUBLISHER_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+#include "rcutils/types/uint8_array.h"
+
+#include "rmw/types.h"
+
+#include "rosidl_typesupport_connext_cpp/message_type_support.h"
+
+#include "rmw_connext_cpp/publish.hpp"
+
+class ConnextStaticSerializedData;
+class ConnextStaticSerializedDataDataWriter;
+
+/// Writes only the latest message of a publisher, at most once per interval.
+/**
+ * Publishing serializes the message over the previous one which has not been written yet.
+ * A timer thread writes the latest message as soon as the interval since the previous write
+ * has passed, so a message published after a quiet period is written right away.
+ */
+class ConflatingPublisher
+{
+public:
+  ConflatingPublisher(
+    ConnextStaticSerializedDataDataWriter * data_writer,
+    std::chrono::nanoseconds interval);
+
+  /// Stops the timer thread, see stop().
+  ~ConflatingPublisher();
+
+  /// Launch the timer thread.
+  /**
+   * \return false if the resources could not be allocated, with the error message set
+   */
+  bool
+  start();
+
+  /// Write the pending message and join the timer thread.
+  void
+  stop();
+
+  /// Serialize a message, replacing the pending one.
+  rmw_ret_t
+  push(const message_type_support_callbacks_t * callbacks, const void * ros_message);
+
+  /// Copy a serialized message, replacing the pending one.
+  rmw_ret_t
+  push_serialized(const rcutils_uint8_array_t * serialized_message);
+
+  /// Gather the fragments of a serialized message, replacing the pending one.
+  rmw_ret_t
+  push_fragments(
+    const rmw_connext_cpp::SerializedMessageFragment * fragments,
+    size_t fragment_count,
+    size_t total_length);
+
+  /// Write the pending message without waiting for the interval and block until it is written.
+  void
+  flush();
+
+  /// Number of messages replaced before they were written.
+  uint64_t
+  conflated() const;
+
+private:
+  // Mark latest_ as pending, called with mutex_ held.
+  void
+  commit_locked();
+
+  // Forget the pending message after latest_ was overwritten, called with mutex_ held.
+  void
+  discard_locked();
+
+  void
+  run();
+
+  ConnextStaticSerializedDataDataWriter * data_writer_;
+  ConnextStaticSerializedData * instance_;
+  const std::chrono::nanoseconds interval_;
+
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  /// Signaled when the timer thread finished writing or the pending message was discarded.
+  std::condition_variable flushed_cv_;
+  /// Most recent message, guarded by mutex_.
+  rcutils_uint8_array_t latest_;
+  /// Message being written, only used by the timer thread.
+  rcutils_uint8_array_t writing_;
+  bool pending_;
+  /// Set by flush() to write the pending message right away.
+  bool flush_requested_;
+  /// Set while the timer thread writes writing_ without holding mutex_.
+  bool write_in_progress_;
+  bool stop_;
+  std::atomic<uint64_t> conflated_;
+  std::thread thread_;
+};
+
+#endif  // CONFLATING_PUBLISHER_HPP_
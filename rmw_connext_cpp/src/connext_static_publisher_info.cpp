@@ -13,6 +13,9 @@
 // limitations under the License.
 
 
+#include <algorithm>
+#include <cstring>
+
 #include "rmw_connext_cpp/connext_static_publisher_info.hpp"
 #include "rmw_connext_shared_cpp/event_converter.hpp"
 
@@ -68,3 +71,40 @@ DDS::Entity * ConnextStaticPublisherInfo::get_entity()
 {
   return topic_writer_;
 }
+
+void * ConnextStaticPublisherInfo::borrow_loaned_message()
+{
+  void * message = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(loan_mutex_);
+    if (loan_free_.empty()) {
+      return nullptr;
+    }
+    message = loan_free_.back();
+    loan_free_.pop_back();
+  }
+  memset(message, 0, loan_message_size_);
+  return message;
+}
+
+bool ConnextStaticPublisherInfo::is_in_loan_pool(const void * message) const
+{
+  auto bytes = static_cast<const uint8_t *>(message);
+  return loan_pool_ && bytes >= loan_pool_ &&
+         bytes < loan_pool_ + loan_pool_size_ * loan_message_size_ &&
+         (bytes - loan_pool_) % loan_message_size_ == 0;
+}
+
+bool ConnextStaticPublisherInfo::return_loaned_message(void * message)
+{
+  if (!is_in_loan_pool(message)) {
+    return false;
+  }
+  std::lock_guard<std::mutex> lock(loan_mutex_);
+  if (std::find(loan_free_.begin(), loan_free_.end(), message) != loan_free_.end()) {
+    return false;
+  }
+  // capacity is reserved for the whole pool, this never allocates
+  loan_free_.push_back(message);
+  return true;
+}
@@ -12,9 +12,37 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <mutex>
+#include <new>
+
+#include "rmw/allocators.h"
+#include "rmw/error_handling.h"
+#include "rmw/impl/cpp/macros.hpp"
+
 #include "rmw_connext_cpp/connext_static_subscriber_info.hpp"
 #include "rmw_connext_shared_cpp/event_converter.hpp"
 
+// include patched generated code from the build folder
+#include "connext_static_serialized_dataSupport.h"
+
+static void
+destroy_serialized_loan(ConnextStaticSerializedLoan * loan)
+{
+  if (loan->dds_messages_) {
+    RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+      loan->dds_messages_->~ConnextStaticSerializedDataSeq(), ConnextStaticSerializedDataSeq)
+    rmw_free(loan->dds_messages_);
+  }
+  if (loan->sample_infos_) {
+    RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+      loan->sample_infos_->~DDS_SampleInfoSeq(), DDS_SampleInfoSeq)
+    rmw_free(loan->sample_infos_);
+  }
+  RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+    loan->~ConnextStaticSerializedLoan(), ConnextStaticSerializedLoan)
+  rmw_free(loan);
+}
+
 rmw_ret_t ConnextStaticSubscriberInfo::get_status(
   DDS::StatusMask mask,
   void * event)
@@ -70,3 +98,118 @@ DDS::Entity * ConnextStaticSubscriberInfo::get_entity()
 {
   return topic_reader_;
 }
+
+ConnextStaticSerializedLoan * ConnextStaticSubscriberInfo::acquire_serialized_loan()
+{
+  {
+    std::lock_guard<std::mutex> lock(serialized_loans_mutex_);
+    if (!serialized_loans_free_.empty()) {
+      ConnextStaticSerializedLoan * loan = serialized_loans_free_.back();
+      serialized_loans_free_.pop_back();
+      return loan;
+    }
+  }
+
+  ConnextStaticSerializedLoan * loan = nullptr;
+  void * buf = rmw_allocate(sizeof(ConnextStaticSerializedLoan));
+  if (!buf) {
+    RMW_SET_ERROR_MSG("failed to allocate memory");
+    return nullptr;
+  }
+  RMW_TRY_PLACEMENT_NEW(loan, buf, goto fail, ConnextStaticSerializedLoan, )
+  buf = nullptr;
+  loan->dds_messages_ = nullptr;
+  loan->sample_infos_ = nullptr;
+  loan->buffer_ = nullptr;
+  buf = rmw_allocate(sizeof(ConnextStaticSerializedDataSeq));
+  if (!buf) {
+    RMW_SET_ERROR_MSG("failed to allocate memory");
+    goto fail;
+  }
+  RMW_TRY_PLACEMENT_NEW(loan->dds_messages_, buf, goto fail, ConnextStaticSerializedDataSeq, )
+  buf = nullptr;
+  buf = rmw_allocate(sizeof(DDS::SampleInfoSeq));
+  if (!buf) {
+    RMW_SET_ERROR_MSG("failed to allocate memory");
+    goto fail;
+  }
+  RMW_TRY_PLACEMENT_NEW(loan->sample_infos_, buf, goto fail, DDS::SampleInfoSeq, )
+  buf = nullptr;
+  try {
+    std::lock_guard<std::mutex> lock(serialized_loans_mutex_);
+    serialized_loans_.reserve(serialized_loan_count_ + 1);
+    serialized_loans_free_.reserve(serialized_loan_count_ + 1);
+    ++serialized_loan_count_;
+  } catch (const std::bad_alloc &) {
+    RMW_SET_ERROR_MSG("failed to allocate memory");
+    goto fail;
+  }
+  return loan;
+
+fail:
+  if (loan) {
+    destroy_serialized_loan(loan);
+  }
+  if (buf) {
+    rmw_free(buf);
+  }
+  return nullptr;
+}
+
+void ConnextStaticSubscriberInfo::release_serialized_loan(ConnextStaticSerializedLoan * loan)
+{
+  std::lock_guard<std::mutex> lock(serialized_loans_mutex_);
+  serialized_loans_free_.push_back(loan);
+}
+
+void ConnextStaticSubscriberInfo::add_serialized_loan(
+  const uint8_t * buffer,
+  ConnextStaticSerializedLoan * loan)
+{
+  std::lock_guard<std::mutex> lock(serialized_loans_mutex_);
+  loan->buffer_ = buffer;
+  serialized_loans_.push_back(loan);
+}
+
+ConnextStaticSerializedLoan * ConnextStaticSubscriberInfo::remove_serialized_loan(
+  const uint8_t * buffer)
+{
+  std::lock_guard<std::mutex> lock(serialized_loans_mutex_);
+  // Only a handful of samples are loaned at a time, so a linear search is cheap.
+  for (auto it = serialized_loans_.begin(); it != serialized_loans_.end(); ++it) {
+    ConnextStaticSerializedLoan * loan = *it;
+    if (loan->buffer_ == buffer) {
+      *it = serialized_loans_.back();
+      serialized_loans_.pop_back();
+      loan->buffer_ = nullptr;
+      return loan;
+    }
+  }
+  return nullptr;
+}
+
+rmw_ret_t ConnextStaticSubscriberInfo::return_serialized_loans()
+{
+  rmw_ret_t result = RMW_RET_OK;
+  std::lock_guard<std::mutex> lock(serialized_loans_mutex_);
+  if (!serialized_loans_.empty()) {
+    ConnextStaticSerializedDataDataReader * data_reader =
+      ConnextStaticSerializedDataDataReader::narrow(topic_reader_);
+    for (auto loan : serialized_loans_) {
+      if (!data_reader ||
+        data_reader->return_loan(*loan->dds_messages_, *loan->sample_infos_) != DDS::RETCODE_OK)
+      {
+        RMW_SET_ERROR_MSG("failed to return loaned sample");
+        result = RMW_RET_ERROR;
+      }
+      destroy_serialized_loan(loan);
+    }
+    serialized_loans_.clear();
+  }
+  for (auto loan : serialized_loans_free_) {
+    destroy_serialized_loan(loan);
+  }
+  serialized_loans_free_.clear();
+  serialized_loan_count_ = 0;
+  return result;
+}
@@ -0,0 +1,323 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <system_error>
+
+#include "rcutils/logging_macros.h"
+
+#include "rmw/error_handling.h"
+
+#include "deferred_publish_queue.hpp"
+#include "publish_helpers.hpp"
+
+// include patched generated code from the build folder
+#include "connext_static_serialized_dataSupport.h"
+
+DeferredPublishQueue::DeferredPublishQueue(
+  ConnextStaticSerializedDataDataWriter * data_writer,
+  size_t depth,
+  size_t slot_capacity,
+  rmw_connext_cpp::OverflowPolicy overflow_policy)
+: data_writer_(data_writer),
+  instance_(nullptr),
+  slot_count_(depth),
+  slot_capacity_(slot_capacity),
+  overflow_policy_(overflow_policy),
+  free_slots_(depth),
+  ready_slots_(depth),
+  ready_count_(0),
+  dropped_(0),
+  committed_count_(0),
+  completed_count_(0),
+  writer_waiting_(false),
+  producers_waiting_(0),
+  flushers_waiting_(0),
+  stop_(false)
+{}
+
+DeferredPublishQueue::~DeferredPublishQueue()
+{
+  stop();
+  for (auto & slot : slots_) {
+    if (slot.buffer) {
+      slot.allocator.deallocate(slot.buffer, slot.allocator.state);
+    }
+  }
+  if (instance_) {
+    ConnextStaticSerializedDataTypeSupport::delete_data(instance_);
+  }
+}
+
+bool
+DeferredPublishQueue::start()
+{
+  instance_ = ConnextStaticSerializedDataTypeSupport::create_data();
+  if (!instance_) {
+    RMW_SET_ERROR_MSG("failed to create dds message instance");
+    return false;
+  }
+  // The sample only ever loans the buffer of the slot being written.
+  if (!instance_->serialized_data.maximum(0)) {
+    RMW_SET_ERROR_MSG("failed to release memory of dds message instance");
+    return false;
+  }
+
+  slots_.resize(slot_count_, rcutils_get_zero_initialized_uint8_array());
+  for (size_t i = 0; i < slot_count_; ++i) {
+    rcutils_uint8_array_t & slot = slots_[i];
+    slot.allocator = rcutils_get_default_allocator();
+    if (slot_capacity_ > 0) {
+      slot.buffer = static_cast<uint8_t *>(
+        slot.allocator.allocate(slot_capacity_, slot.allocator.state));
+      if (!slot.buffer) {
+        RMW_SET_ERROR_MSG("failed to allocate memory for the deferred publish queue");
+        return false;
+      }
+      slot.buffer_capacity = slot_capacity_;
+    }
+    free_slots_.push(i);
+  }
+
+  try {
+    thread_ = std::thread(&DeferredPublishQueue::run, this);
+  } catch (const std::system_error &) {
+    RMW_SET_ERROR_MSG("failed to start the writer thread of the deferred publish queue");
+    return false;
+  }
+  return true;
+}
+
+void
+DeferredPublishQueue::stop()
+{
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stop_ = true;
+  }
+  writer_cv_.notify_one();
+  producer_cv_.notify_all();
+  flush_cv_.notify_all();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+rmw_ret_t
+DeferredPublishQueue::push(
+  const message_type_support_callbacks_t * callbacks,
+  const void * ros_message)
+{
+  size_t index = 0;
+  if (!acquire_slot(index)) {
+    if (stop_) {
+      RMW_SET_ERROR_MSG("publisher is shutting down");
+      return RMW_RET_ERROR;
+    }
+    return RMW_RET_OK;
+  }
+
+  rcutils_uint8_array_t * slot = &slots_[index];
+  if (!slot->buffer) {
+    slot->buffer_capacity = 0;
+  }
+  slot->buffer_length = 0;
+  if (!callbacks->to_cdr_stream(ros_message, slot)) {
+    release_slot(index);
+    RMW_SET_ERROR_MSG("failed to convert ros_message to cdr stream");
+    return RMW_RET_ERROR;
+  }
+  // to_cdr_stream() reallocates the buffer when it is too small, but does not
+  // update the capacity accordingly.
+  if (slot->buffer_capacity < slot->buffer_length) {
+    slot->buffer_capacity = slot->buffer_length;
+  }
+  if (!slot->buffer || slot->buffer_length == 0) {
+    release_slot(index);
+    RMW_SET_ERROR_MSG("no serialized message attached");
+    return RMW_RET_ERROR;
+  }
+  commit_slot(index);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+DeferredPublishQueue::push_serialized(const rcutils_uint8_array_t * serialized_message)
+{
+  if (!serialized_message->buffer || serialized_message->buffer_length == 0) {
+    RMW_SET_ERROR_MSG("no serialized message attached");
+    return RMW_RET_ERROR;
+  }
+  rmw_connext_cpp::SerializedMessageFragment fragment;
+  fragment.buffer = serialized_message->buffer;
+  fragment.length = serialized_message->buffer_length;
+  return push_fragments(&fragment, 1, fragment.length);
+}
+
+rmw_ret_t
+DeferredPublishQueue::push_fragments(
+  const rmw_connext_cpp::SerializedMessageFragment * fragments,
+  size_t fragment_count,
+  size_t total_length)
+{
+  size_t index = 0;
+  if (!acquire_slot(index)) {
+    if (stop_) {
+      RMW_SET_ERROR_MSG("publisher is shutting down");
+      return RMW_RET_ERROR;
+    }
+    return RMW_RET_OK;
+  }
+
+  rmw_ret_t ret = gather_fragments(fragments, fragment_count, total_length, &slots_[index]);
+  if (ret != RMW_RET_OK) {
+    release_slot(index);
+    return ret;
+  }
+  commit_slot(index);
+  return RMW_RET_OK;
+}
+
+void
+DeferredPublishQueue::flush()
+{
+  // The writer thread handles messages in the order they were queued, and dropping always
+  // takes the oldest one, so the messages queued so far are done once as many completed.
+  const uint64_t target = committed_count_;
+  if (completed_count_ >= target) {
+    return;
+  }
+  std::unique_lock<std::mutex> lock(sleep_mutex_);
+  ++flushers_waiting_;
+  flush_cv_.wait(
+    lock, [this, target]() {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      return stop_ || completed_count_ >= target;
+    });
+  --flushers_waiting_;
+}
+
+size_t
+DeferredPublishQueue::depth() const
+{
+  return ready_count_;
+}
+
+uint64_t
+DeferredPublishQueue::dropped() const
+{
+  return dropped_;
+}
+
+bool
+DeferredPublishQueue::acquire_slot(size_t & index)
+{
+  if (free_slots_.pop(index)) {
+    return true;
+  }
+  switch (overflow_policy_) {
+    case rmw_connext_cpp::OverflowPolicy::drop_newest:
+      ++dropped_;
+      return false;
+    case rmw_connext_cpp::OverflowPolicy::drop_oldest:
+      // Take over the slot of the oldest queued message. Both queues can be empty
+      // for a moment while every slot is being filled or written by other threads.
+      while (true) {
+        if (ready_slots_.pop(index)) {
+          --ready_count_;
+          ++dropped_;
+          complete_message();
+          return true;
+        }
+        if (free_slots_.pop(index)) {
+          return true;
+        }
+        std::this_thread::yield();
+      }
+    case rmw_connext_cpp::OverflowPolicy::block:
+    default:
+      {
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        ++producers_waiting_;
+        producer_cv_.wait(
+          lock, [this, &index]() {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return stop_ || free_slots_.pop(index);
+          });
+        --producers_waiting_;
+        return !stop_;
+      }
+  }
+}
+
+void
+DeferredPublishQueue::commit_slot(size_t index)
+{
+  // Counted before pushing so that the count never falls below the number of queued slots.
+  ++ready_count_;
+  ++committed_count_;
+  // Never fails, each queue can hold all slots.
+  ready_slots_.push(index);
+  if (writer_waiting_) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    writer_cv_.notify_one();
+  }
+}
+
+void
+DeferredPublishQueue::release_slot(size_t index)
+{
+  free_slots_.push(index);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (producers_waiting_ > 0) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    producer_cv_.notify_one();
+  }
+}
+
+void
+DeferredPublishQueue::complete_message()
+{
+  ++completed_count_;
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (flushers_waiting_ > 0) {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    flush_cv_.notify_all();
+  }
+}
+
+void
+DeferredPublishQueue::run()
+{
+  while (true) {
+    size_t index = 0;
+    if (ready_slots_.pop(index)) {
+      --ready_count_;
+      if (!publish(data_writer_, instance_, &slots_[index])) {
+        RCUTILS_LOG_ERROR_NAMED(
+          "rmw_connext_cpp", "failed to write message from the deferred publish queue");
+      }
+      release_slot(index);
+      complete_message();
+      continue;
+    }
+    // Only exit once every queued message has been written.
+    if (stop_) {
+      break;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    writer_waiting_ = true;
+    writer_cv_.wait(lock, [this]() {return ready_count_ > 0 || stop_;});
+    writer_waiting_ = false;
+  }
+}
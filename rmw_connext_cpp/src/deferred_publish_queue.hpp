@@ -0,0 +1,144 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DEFERRED_PUBLISH_QUEUE_HPP_
+#define DEFERRED_PUBLISH_QUEUE_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "rcutils/types/uint8_array.h"
+
+#include "rmw/types.h"
+
+#include "rosidl_typesupport_connext_cpp/message_type_support.h"
+
+#include "rmw_connext_cpp/publish.hpp"
+#include "rmw_connext_cpp/publisher_options.hpp"
+
+#include "bounded_index_queue.hpp"
+
+class ConnextStaticSerializedData;
+class ConnextStaticSerializedDataDataWriter;
+
+/// Publishes messages of one publisher from a dedicated writer thread.
+/**
+ * Messages are serialized on the caller's thread into one of a fixed number of
+ * preallocated slots, which is then handed to the writer thread through a lock-free queue.
+ * The writer thread is the only one using its DDS sample, so no lock is held while writing.
+ */
+class DeferredPublishQueue
+{
+public:
+  DeferredPublishQueue(
+    ConnextStaticSerializedDataDataWriter * data_writer,
+    size_t depth,
+    size_t slot_capacity,
+    rmw_connext_cpp::OverflowPolicy overflow_policy);
+
+  /// Stops the writer thread, see stop().
+  ~DeferredPublishQueue();
+
+  /// Allocate the slots and launch the writer thread.
+  /**
+   * \return false if the resources could not be allocated, with the error message set
+   */
+  bool
+  start();
+
+  /// Write all queued messages and join the writer thread.
+  void
+  stop();
+
+  /// Serialize a message into a free slot and queue it.
+  rmw_ret_t
+  push(const message_type_support_callbacks_t * callbacks, const void * ros_message);
+
+  /// Copy a serialized message into a free slot and queue it.
+  rmw_ret_t
+  push_serialized(const rcutils_uint8_array_t * serialized_message);
+
+  /// Gather the fragments of a serialized message straight into a free slot and queue it.
+  rmw_ret_t
+  push_fragments(
+    const rmw_connext_cpp::SerializedMessageFragment * fragments,
+    size_t fragment_count,
+    size_t total_length);
+
+  /// Block until every message queued before the call has been written or dropped.
+  void
+  flush();
+
+  /// Number of messages currently waiting for the writer thread.
+  size_t
+  depth() const;
+
+  /// Number of messages dropped because the queue was full.
+  uint64_t
+  dropped() const;
+
+private:
+  // Acquire a free slot according to the overflow policy, return false if the message is dropped.
+  bool
+  acquire_slot(size_t & index);
+
+  // Queue a filled slot and wake the writer thread if it is idle.
+  void
+  commit_slot(size_t index);
+
+  // Give a slot back to the free queue and wake a blocked producer.
+  void
+  release_slot(size_t index);
+
+  // Count a queued message as written or dropped and wake threads waiting in flush().
+  void
+  complete_message();
+
+  void
+  run();
+
+  ConnextStaticSerializedDataDataWriter * data_writer_;
+  ConnextStaticSerializedData * instance_;
+  const size_t slot_count_;
+  const size_t slot_capacity_;
+  const rmw_connext_cpp::OverflowPolicy overflow_policy_;
+
+  std::vector<rcutils_uint8_array_t> slots_;
+  BoundedIndexQueue free_slots_;
+  BoundedIndexQueue ready_slots_;
+  std::atomic<size_t> ready_count_;
+  std::atomic<uint64_t> dropped_;
+  /// Number of messages ever queued and ever written or dropped from the queue, for flush().
+  std::atomic<uint64_t> committed_count_;
+  std::atomic<uint64_t> completed_count_;
+
+  // Only used to put the writer thread or blocked producers to sleep.
+  std::mutex sleep_mutex_;
+  std::condition_variable writer_cv_;
+  std::condition_variable producer_cv_;
+  std::condition_variable flush_cv_;
+  std::atomic<bool> writer_waiting_;
+  std::atomic<size_t> producers_waiting_;
+  std::atomic<size_t> flushers_waiting_;
+  std::atomic<bool> stop_;
+  std::thread thread_;
+};
+
+#endif  // DEFERRED_PUBLISH_QUEUE_HPP_
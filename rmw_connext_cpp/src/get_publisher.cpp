@@ -14,9 +14,14 @@
 
 #include "rmw_connext_cpp/get_publisher.hpp"
 
+#include "rmw/error_handling.h"
+
 #include "rmw_connext_cpp/connext_static_publisher_info.hpp"
 #include "rmw_connext_cpp/identifier.hpp"
 
+#include "conflating_publisher.hpp"
+#include "deferred_publish_queue.hpp"
+
 namespace rmw_connext_cpp
 {
 
@@ -33,4 +38,30 @@ get_data_writer(rmw_publisher_t * publisher)
   return impl->topic_writer_;
 }
 
+rmw_ret_t
+get_publisher_statistics(const rmw_publisher_t * publisher, PublisherStatistics * statistics)
+{
+  if (!publisher || !statistics) {
+    RMW_SET_ERROR_MSG("publisher or statistics handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  if (publisher->implementation_identifier != rti_connext_identifier) {
+    RMW_SET_ERROR_MSG("publisher handle is not from this rmw implementation");
+    return RMW_RET_ERROR;
+  }
+  auto impl = static_cast<const ConnextStaticPublisherInfo *>(publisher->data);
+  statistics->skipped_unmatched = impl->skipped_unmatched_;
+  statistics->deferred_queue_depth = 0;
+  statistics->deferred_dropped = 0;
+  statistics->conflated = 0;
+  if (impl->deferred_queue_) {
+    statistics->deferred_queue_depth = impl->deferred_queue_->depth();
+    statistics->deferred_dropped = impl->deferred_queue_->dropped();
+  }
+  if (impl->conflating_publisher_) {
+    statistics->conflated = impl->conflating_publisher_->conflated();
+  }
+  return RMW_RET_OK;
+}
+
 }  // namespace rmw_connext_cpp
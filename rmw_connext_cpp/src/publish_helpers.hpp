@@ -0,0 +1,48 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PUBLISH_HELPERS_HPP_
+#define PUBLISH_HELPERS_HPP_
+
+#include <cstddef>
+
+#include "rcutils/types/uint8_array.h"
+
+#include "rmw/types.h"
+
+#include "rmw_connext_cpp/publish.hpp"
+
+class ConnextStaticSerializedData;
+class ConnextStaticSerializedDataDataWriter;
+
+/// Write a serialized message by loaning it into the given sample.
+bool
+publish(
+  ConnextStaticSerializedDataDataWriter * data_writer,
+  ConnextStaticSerializedData * instance,
+  const rcutils_uint8_array_t * cdr_stream);
+
+/// Concatenate fragments into a buffer, which is grown if it is too small.
+/**
+ * \return `RMW_RET_OK` if successful, or
+ * \return `RMW_RET_BAD_ALLOC` if the buffer can't grow, with the error message set
+ */
+rmw_ret_t
+gather_fragments(
+  const rmw_connext_cpp::SerializedMessageFragment * fragments,
+  size_t fragment_count,
+  size_t total_length,
+  rcutils_uint8_array_t * buffer);
+
+#endif  // PUBLISH_HELPERS_HPP_
@@ -0,0 +1,65 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+
+#include "rcutils/get_env.h"
+
+#include "rmw_connext_cpp/publisher_options.hpp"
+
+namespace
+{
+
+bool
+get_env_flag(const char * name)
+{
+  const char * value = nullptr;
+  if (rcutils_get_env(name, &value) != NULL || !value) {
+    return false;
+  }
+  return strcmp(value, "1") == 0 || strcmp(value, "true") == 0;
+}
+
+rmw_connext_cpp::PublishMode
+get_env_publish_mode(const char * name)
+{
+  const char * value = nullptr;
+  if (rcutils_get_env(name, &value) != NULL || !value) {
+    return rmw_connext_cpp::PublishMode::automatic;
+  }
+  if (strcmp(value, "synchronous") == 0) {
+    return rmw_connext_cpp::PublishMode::synchronous;
+  }
+  if (strcmp(value, "asynchronous") == 0) {
+    return rmw_connext_cpp::PublishMode::asynchronous;
+  }
+  return rmw_connext_cpp::PublishMode::automatic;
+}
+
+}  // namespace
+
+namespace rmw_connext_cpp
+{
+
+PublisherOptions
+get_default_publisher_options()
+{
+  PublisherOptions options;
+  options.skip_when_unmatched = get_env_flag("RMW_CONNEXT_PUBLISHER_SKIP_WHEN_UNMATCHED");
+  options.publish_mode = get_env_publish_mode("RMW_CONNEXT_PUBLISH_MODE");
+  options.batch_enable = get_env_flag("RMW_CONNEXT_PUBLISHER_BATCHING");
+  return options;
+}
+
+}  // namespace rmw_connext_cpp
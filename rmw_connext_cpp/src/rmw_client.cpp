@@ -21,6 +21,8 @@
 
 #include "rmw_connext_shared_cpp/types.hpp"
 #include "rmw_connext_shared_cpp/qos.hpp"
+#include "rmw_connext_shared_cpp/wait_notifier.hpp"
+#include "rmw_connext_shared_cpp/wait_set.hpp"
 
 #include "rmw_connext_cpp/connext_static_client_info.hpp"
 #include "rmw_connext_cpp/identifier.hpp"
@@ -85,6 +87,7 @@ rmw_create_client(
   DDS::DataReader * response_datareader = nullptr;
   DDS::DataWriter * request_datawriter = nullptr;
   DDS::ReadCondition * read_condition = nullptr;
+  ConnextWaitNotifier * wait_notifier = nullptr;
   void * requester = nullptr;
   void * buf = nullptr;
   ConnextStaticClientInfo * client_info = nullptr;
@@ -173,6 +176,18 @@ rmw_create_client(
     goto fail;
   }
 
+  wait_notifier = create_wait_notifier();
+  if (!wait_notifier) {
+    // error string was set within the function
+    goto fail;
+  }
+  // only notifies epoll wait sets of arriving responses
+  status = response_datareader->set_listener(wait_notifier, DDS::DATA_AVAILABLE_STATUS);
+  if (status != DDS::RETCODE_OK) {
+    RMW_SET_ERROR_MSG("failed to set datareader listener");
+    goto fail;
+  }
+
   buf = rmw_allocate(sizeof(ConnextStaticClientInfo));
   if (!buf) {
     RMW_SET_ERROR_MSG("failed to allocate memory");
@@ -186,6 +201,7 @@ rmw_create_client(
   client_info->callbacks_ = callbacks;
   client_info->response_datareader_ = response_datareader;
   client_info->read_condition_ = read_condition;
+  client_info->wait_notifier_ = wait_notifier;
 
   client->implementation_identifier = rti_connext_identifier;
   client->data = client_info;
@@ -239,6 +255,13 @@ fail:
   if (client) {
     rmw_client_free(client);
   }
+  // the listener has to be removed before the notifier goes
+  if (wait_notifier) {
+    if (response_datareader) {
+      response_datareader->set_listener(nullptr, DDS::STATUS_MASK_NONE);
+    }
+    destroy_wait_notifier(wait_notifier);
+  }
   if (response_datareader && dds_subscriber) {
     if (dds_subscriber->delete_datareader(response_datareader) != DDS::RETCODE_OK) {
       std::stringstream ss;
@@ -298,6 +321,8 @@ rmw_destroy_client(rmw_node_t * node, rmw_client_t * client)
     if (response_datareader) {
       auto read_condition = client_info->read_condition_;
       if (read_condition) {
+        // the condition stays attached to the wait sets which waited on it last
+        detach_from_wait_sets(read_condition);
         if (response_datareader->delete_readcondition(read_condition) != DDS::RETCODE_OK) {
           RMW_SET_ERROR_MSG("failed to delete readcondition");
           result = RMW_RET_ERROR;
@@ -308,6 +333,17 @@ rmw_destroy_client(rmw_node_t * node, rmw_client_t * client)
       RMW_SET_ERROR_MSG("cannot delete readcondition because the datareader is null");
       result = RMW_RET_ERROR;
     }
+    if (client_info->wait_notifier_) {
+      if (
+        response_datareader &&
+        response_datareader->set_listener(nullptr, DDS::STATUS_MASK_NONE) != DDS::RETCODE_OK)
+      {
+        RMW_SET_ERROR_MSG("failed to unset datareader listener");
+        result = RMW_RET_ERROR;
+      }
+      destroy_wait_notifier(client_info->wait_notifier_);
+      client_info->wait_notifier_ = nullptr;
+    }
     const service_type_support_callbacks_t * callbacks = client_info->callbacks_;
     if (callbacks) {
       if (client_info->requester_) {
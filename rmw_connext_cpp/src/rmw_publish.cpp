@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstring>
 #include <limits>
+#include <mutex>
 
 #include "rmw/error_handling.h"
 #include "rmw/rmw.h"
@@ -20,29 +22,21 @@
 
 #include "rmw_connext_cpp/connext_static_publisher_info.hpp"
 #include "rmw_connext_cpp/identifier.hpp"
+#include "rmw_connext_cpp/publish.hpp"
+
+#include "conflating_publisher.hpp"
+#include "deferred_publish_queue.hpp"
+#include "publish_helpers.hpp"
 
 // include patched generated code from the build folder
 #include "connext_static_serialized_dataSupport.h"
 
 bool
-publish(DDS::DataWriter * dds_data_writer, const rcutils_uint8_array_t * cdr_stream)
+publish(
+  ConnextStaticSerializedDataDataWriter * data_writer,
+  ConnextStaticSerializedData * instance,
+  const rcutils_uint8_array_t * cdr_stream)
 {
-  ConnextStaticSerializedDataDataWriter * data_writer =
-    ConnextStaticSerializedDataDataWriter::narrow(dds_data_writer);
-  if (!data_writer) {
-    RMW_SET_ERROR_MSG("failed to narrow data writer");
-    return false;
-  }
-
-  ConnextStaticSerializedData * instance = ConnextStaticSerializedDataTypeSupport::create_data();
-  if (!instance) {
-    RMW_SET_ERROR_MSG("failed to create dds message instance");
-    return false;
-  }
-
-  DDS::ReturnCode_t status = DDS::RETCODE_ERROR;
-
-  instance->serialized_data.maximum(0);
   if (cdr_stream->buffer_length > (std::numeric_limits<DDS_Long>::max)()) {
     RMW_SET_ERROR_MSG("cdr_stream->buffer_length unexpectedly larger than DDS_Long's max value");
     return false;
@@ -53,23 +47,127 @@ publish(DDS::DataWriter * dds_data_writer, const rcutils_uint8_array_t * cdr_str
       static_cast<DDS::Long>(cdr_stream->buffer_length)))
   {
     RMW_SET_ERROR_MSG("failed to loan memory for message");
-    goto cleanup;
+    return false;
   }
 
-  status = data_writer->write(*instance, DDS::HANDLE_NIL);
+  DDS::ReturnCode_t status = data_writer->write(*instance, DDS::HANDLE_NIL);
 
-cleanup:
-  if (instance) {
-    if (!instance->serialized_data.unloan()) {
-      fprintf(stderr, "failed to return loaned memory\n");
-      status = DDS::RETCODE_ERROR;
-    }
-    ConnextStaticSerializedDataTypeSupport::delete_data(instance);
+  if (!instance->serialized_data.unloan()) {
+    fprintf(stderr, "failed to return loaned memory\n");
+    status = DDS::RETCODE_ERROR;
   }
 
   return status == DDS::RETCODE_OK;
 }
 
+rmw_ret_t
+gather_fragments(
+  const rmw_connext_cpp::SerializedMessageFragment * fragments,
+  size_t fragment_count,
+  size_t total_length,
+  rcutils_uint8_array_t * buffer)
+{
+  if (!buffer->buffer || buffer->buffer_capacity < total_length) {
+    // The previous content is overwritten anyway, so there is nothing to reallocate.
+    if (buffer->buffer) {
+      buffer->allocator.deallocate(buffer->buffer, buffer->allocator.state);
+    }
+    buffer->buffer_capacity = 0;
+    buffer->buffer = static_cast<uint8_t *>(
+      buffer->allocator.allocate(total_length, buffer->allocator.state));
+    if (!buffer->buffer) {
+      buffer->buffer_length = 0;
+      RMW_SET_ERROR_MSG("failed to allocate memory for the serialized message");
+      return RMW_RET_BAD_ALLOC;
+    }
+    buffer->buffer_capacity = total_length;
+  }
+  buffer->buffer_length = 0;
+  for (size_t i = 0; i < fragment_count; ++i) {
+    if (fragments[i].length != 0) {
+      memcpy(buffer->buffer + buffer->buffer_length, fragments[i].buffer, fragments[i].length);
+      buffer->buffer_length += fragments[i].length;
+    }
+  }
+  return RMW_RET_OK;
+}
+
+// Prepare the publisher's serialization buffer for the next message.
+static void
+reset_cdr_stream(rcutils_uint8_array_t * cdr_stream)
+{
+  if (cdr_stream->buffer_capacity > ConnextStaticPublisherInfo::max_cached_cdr_stream_capacity) {
+    cdr_stream->allocator.deallocate(cdr_stream->buffer, cdr_stream->allocator.state);
+    cdr_stream->buffer = nullptr;
+    cdr_stream->buffer_capacity = 0;
+  }
+  cdr_stream->buffer_length = 0;
+}
+
+// Return true and count the message if it should be dropped since nobody listens.
+static bool
+skip_unmatched(ConnextStaticPublisherInfo * publisher_info)
+{
+  if (!publisher_info->skip_when_unmatched_ || publisher_info->listener_->current_count() != 0) {
+    return false;
+  }
+  ++publisher_info->skipped_unmatched_;
+  return true;
+}
+
+static ConnextStaticPublisherAllocation *
+get_allocation_info(
+  rmw_publisher_allocation_t * allocation,
+  const message_type_support_callbacks_t * callbacks)
+{
+  if (allocation->implementation_identifier != rti_connext_identifier) {
+    RMW_SET_ERROR_MSG("publisher allocation is not from this rmw implementation");
+    return nullptr;
+  }
+  auto allocation_info = static_cast<ConnextStaticPublisherAllocation *>(allocation->data);
+  if (!allocation_info) {
+    RMW_SET_ERROR_MSG("publisher allocation info handle is null");
+    return nullptr;
+  }
+  if (allocation_info->callbacks_ != callbacks) {
+    RMW_SET_ERROR_MSG("publisher allocation was initialized for a different message type");
+    return nullptr;
+  }
+  return allocation_info;
+}
+
+static rmw_ret_t
+publish_with_allocation(
+  ConnextStaticSerializedDataDataWriter * data_writer,
+  const message_type_support_callbacks_t * callbacks,
+  const void * ros_message,
+  ConnextStaticPublisherAllocation * allocation_info)
+{
+  rcutils_uint8_array_t * cdr_stream = &allocation_info->cdr_stream_;
+  cdr_stream->buffer = allocation_info->buffer_;
+  cdr_stream->buffer_capacity = allocation_info->buffer_capacity_;
+  cdr_stream->buffer_length = 0;
+  allocation_info->exhausted_ = false;
+
+  if (!callbacks->to_cdr_stream(ros_message, cdr_stream)) {
+    RMW_SET_ERROR_MSG("failed to convert ros_message to cdr stream");
+    return RMW_RET_ERROR;
+  }
+  if (allocation_info->exhausted_ || cdr_stream->buffer != allocation_info->buffer_) {
+    RMW_SET_ERROR_MSG("serialized message exceeds the preallocated publisher allocation");
+    return RMW_RET_ERROR;
+  }
+  if (cdr_stream->buffer_length == 0) {
+    RMW_SET_ERROR_MSG("no message length set");
+    return RMW_RET_ERROR;
+  }
+  if (!publish(data_writer, allocation_info->instance_, cdr_stream)) {
+    RMW_SET_ERROR_MSG("failed to publish message");
+    return RMW_RET_ERROR;
+  }
+  return RMW_RET_OK;
+}
+
 extern "C"
 {
 rmw_ret_t
@@ -78,7 +176,6 @@ rmw_publish(
   const void * ros_message,
   rmw_publisher_allocation_t * allocation)
 {
-  (void) allocation;
   if (!publisher) {
     RMW_SET_ERROR_MSG("publisher handle is null");
     return RMW_RET_ERROR;
@@ -103,39 +200,75 @@ rmw_publish(
     RMW_SET_ERROR_MSG("callbacks handle is null");
     return RMW_RET_ERROR;
   }
-  DDS::DataWriter * topic_writer = publisher_info->topic_writer_;
-  if (!topic_writer) {
-    RMW_SET_ERROR_MSG("topic writer handle is null");
+  ConnextStaticSerializedDataDataWriter * data_writer = publisher_info->data_writer_;
+  if (!data_writer) {
+    RMW_SET_ERROR_MSG("data writer handle is null");
+    return RMW_RET_ERROR;
+  }
+  ConnextStaticSerializedData * instance = publisher_info->instance_;
+  if (!instance) {
+    RMW_SET_ERROR_MSG("dds message instance is null");
     return RMW_RET_ERROR;
   }
 
+  if (skip_unmatched(publisher_info)) {
+    return RMW_RET_OK;
+  }
+
+  if (allocation) {
+    // The allocation brings its own buffer and sample, no need to lock the publisher.
+    ConnextStaticPublisherAllocation * allocation_info =
+      get_allocation_info(allocation, callbacks);
+    if (!allocation_info) {
+      return RMW_RET_ERROR;
+    }
+    return publish_with_allocation(data_writer, callbacks, ros_message, allocation_info);
+  }
+  if (publisher_info->conflating_publisher_) {
+    return publisher_info->conflating_publisher_->push(callbacks, ros_message);
+  }
+  if (publisher_info->deferred_queue_) {
+    return publisher_info->deferred_queue_->push(callbacks, ros_message);
+  }
+
   auto ret = RMW_RET_OK;
-  rcutils_uint8_array_t cdr_stream = rcutils_get_zero_initialized_uint8_array();
-  cdr_stream.allocator = rcutils_get_default_allocator();
+  // The serialization buffer and the dds sample are owned by the publisher and reused
+  // across calls, so concurrent publishes on the same publisher have to be serialized.
+  std::lock_guard<std::mutex> lock(publisher_info->publish_mutex_);
+  rcutils_uint8_array_t * cdr_stream = &publisher_info->cdr_stream_;
+  if (!cdr_stream->buffer) {
+    cdr_stream->buffer_capacity = 0;
+  }
+  cdr_stream->buffer_length = 0;
 
-  if (!callbacks->to_cdr_stream(ros_message, &cdr_stream)) {
+  if (!callbacks->to_cdr_stream(ros_message, cdr_stream)) {
     RMW_SET_ERROR_MSG("failed to convert ros_message to cdr stream");
     ret = RMW_RET_ERROR;
     goto fail;
   }
-  if (cdr_stream.buffer_length == 0) {
+  // to_cdr_stream() reallocates the buffer when it is too small, but does not
+  // update the capacity accordingly.
+  if (cdr_stream->buffer_capacity < cdr_stream->buffer_length) {
+    cdr_stream->buffer_capacity = cdr_stream->buffer_length;
+  }
+  if (cdr_stream->buffer_length == 0) {
     RMW_SET_ERROR_MSG("no message length set");
     ret = RMW_RET_ERROR;
     goto fail;
   }
-  if (!cdr_stream.buffer) {
+  if (!cdr_stream->buffer) {
     RMW_SET_ERROR_MSG("no serialized message attached");
     ret = RMW_RET_ERROR;
     goto fail;
   }
-  if (!publish(topic_writer, &cdr_stream)) {
+  if (!publish(data_writer, instance, cdr_stream)) {
     RMW_SET_ERROR_MSG("failed to publish message");
     ret = RMW_RET_ERROR;
     goto fail;
   }
 
 fail:
-  cdr_stream.allocator.deallocate(cdr_stream.buffer, cdr_stream.allocator.state);
+  reset_cdr_stream(cdr_stream);
   return ret;
 }
 
@@ -145,7 +278,6 @@ rmw_publish_serialized_message(
   const rmw_serialized_message_t * serialized_message,
   rmw_publisher_allocation_t * allocation)
 {
-  (void) allocation;
   if (!publisher) {
     RMW_SET_ERROR_MSG("publisher handle is null");
     return RMW_RET_ERROR;
@@ -170,13 +302,37 @@ rmw_publish_serialized_message(
     RMW_SET_ERROR_MSG("callbacks handle is null");
     return RMW_RET_ERROR;
   }
-  DDS::DataWriter * topic_writer = publisher_info->topic_writer_;
-  if (!topic_writer) {
-    RMW_SET_ERROR_MSG("topic writer handle is null");
+  ConnextStaticSerializedDataDataWriter * data_writer = publisher_info->data_writer_;
+  if (!data_writer) {
+    RMW_SET_ERROR_MSG("data writer handle is null");
     return RMW_RET_ERROR;
   }
+  ConnextStaticSerializedData * instance = publisher_info->instance_;
+  if (!instance) {
+    RMW_SET_ERROR_MSG("dds message instance is null");
+    return RMW_RET_ERROR;
+  }
+
+  if (skip_unmatched(publisher_info)) {
+    return RMW_RET_OK;
+  }
 
-  bool published = publish(topic_writer, serialized_message);
+  bool published = false;
+  if (allocation) {
+    ConnextStaticPublisherAllocation * allocation_info =
+      get_allocation_info(allocation, callbacks);
+    if (!allocation_info) {
+      return RMW_RET_ERROR;
+    }
+    published = publish(data_writer, allocation_info->instance_, serialized_message);
+  } else if (publisher_info->conflating_publisher_) {
+    return publisher_info->conflating_publisher_->push_serialized(serialized_message);
+  } else if (publisher_info->deferred_queue_) {
+    return publisher_info->deferred_queue_->push_serialized(serialized_message);
+  } else {
+    std::lock_guard<std::mutex> lock(publisher_info->publish_mutex_);
+    published = publish(data_writer, instance, serialized_message);
+  }
   if (!published) {
     RMW_SET_ERROR_MSG("failed to publish message");
     return RMW_RET_ERROR;
@@ -190,11 +346,162 @@ rmw_publish_loaned_message(
   void * ros_message,
   rmw_publisher_allocation_t * allocation)
 {
-  (void) publisher;
-  (void) ros_message;
-  (void) allocation;
+  if (!publisher) {
+    RMW_SET_ERROR_MSG("publisher handle is null");
+    return RMW_RET_ERROR;
+  }
+  if (publisher->implementation_identifier != rti_connext_identifier) {
+    RMW_SET_ERROR_MSG("publisher handle is not from this rmw implementation");
+    return RMW_RET_ERROR;
+  }
+  if (!ros_message) {
+    RMW_SET_ERROR_MSG("ros message handle is null");
+    return RMW_RET_ERROR;
+  }
+  ConnextStaticPublisherInfo * publisher_info =
+    static_cast<ConnextStaticPublisherInfo *>(publisher->data);
+  if (!publisher_info) {
+    RMW_SET_ERROR_MSG("publisher info handle is null");
+    return RMW_RET_ERROR;
+  }
+  if (!publisher_info->is_in_loan_pool(ros_message)) {
+    RMW_SET_ERROR_MSG("ros message is not loaned from this publisher");
+    return RMW_RET_ERROR;
+  }
 
-  RMW_SET_ERROR_MSG("rmw_publish_loaned_message not implemented for rmw_connext_cpp");
-  return RMW_RET_UNSUPPORTED;
+  // Serializes straight from the loaned memory, the pool takes the message back afterwards.
+  rmw_ret_t ret = rmw_publish(publisher, ros_message, allocation);
+  if (!publisher_info->return_loaned_message(ros_message) && ret == RMW_RET_OK) {
+    RMW_SET_ERROR_MSG("ros message was already returned to the publisher");
+    ret = RMW_RET_ERROR;
+  }
+  return ret;
 }
 }  // extern "C"
+
+namespace rmw_connext_cpp
+{
+
+rmw_ret_t
+flush_publisher(const rmw_publisher_t * publisher)
+{
+  if (!publisher) {
+    RMW_SET_ERROR_MSG("publisher handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  if (publisher->implementation_identifier != rti_connext_identifier) {
+    RMW_SET_ERROR_MSG("publisher handle is not from this rmw implementation");
+    return RMW_RET_ERROR;
+  }
+  auto publisher_info = static_cast<ConnextStaticPublisherInfo *>(publisher->data);
+  if (!publisher_info || !publisher_info->topic_writer_) {
+    RMW_SET_ERROR_MSG("publisher info handle is null");
+    return RMW_RET_ERROR;
+  }
+  // Hand the messages still held by the publisher to the data writer first.
+  if (publisher_info->conflating_publisher_) {
+    publisher_info->conflating_publisher_->flush();
+  }
+  if (publisher_info->deferred_queue_) {
+    publisher_info->deferred_queue_->flush();
+  }
+  if (publisher_info->topic_writer_->flush() != DDS::RETCODE_OK) {
+    RMW_SET_ERROR_MSG("failed to flush data writer");
+    return RMW_RET_ERROR;
+  }
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+publish_serialized_message_fragments(
+  const rmw_publisher_t * publisher,
+  const SerializedMessageFragment * fragments,
+  size_t fragment_count)
+{
+  if (!publisher) {
+    RMW_SET_ERROR_MSG("publisher handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  if (publisher->implementation_identifier != rti_connext_identifier) {
+    RMW_SET_ERROR_MSG("publisher handle is not from this rmw implementation");
+    return RMW_RET_ERROR;
+  }
+  if (!fragments || fragment_count == 0) {
+    RMW_SET_ERROR_MSG("no fragments to publish");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  auto publisher_info = static_cast<ConnextStaticPublisherInfo *>(publisher->data);
+  if (!publisher_info) {
+    RMW_SET_ERROR_MSG("publisher info handle is null");
+    return RMW_RET_ERROR;
+  }
+  ConnextStaticSerializedDataDataWriter * data_writer = publisher_info->data_writer_;
+  if (!data_writer) {
+    RMW_SET_ERROR_MSG("data writer handle is null");
+    return RMW_RET_ERROR;
+  }
+  ConnextStaticSerializedData * instance = publisher_info->instance_;
+  if (!instance) {
+    RMW_SET_ERROR_MSG("dds message instance is null");
+    return RMW_RET_ERROR;
+  }
+
+  size_t total_length = 0;
+  for (size_t i = 0; i < fragment_count; ++i) {
+    if (!fragments[i].buffer && fragments[i].length != 0) {
+      RMW_SET_ERROR_MSG("fragment buffer is null");
+      return RMW_RET_INVALID_ARGUMENT;
+    }
+    if (fragments[i].length > (std::numeric_limits<DDS_Long>::max)() - total_length) {
+      RMW_SET_ERROR_MSG("fragments exceed the maximum size of a sample");
+      return RMW_RET_ERROR;
+    }
+    total_length += fragments[i].length;
+  }
+  if (total_length == 0) {
+    RMW_SET_ERROR_MSG("no message length set");
+    return RMW_RET_ERROR;
+  }
+
+  if (skip_unmatched(publisher_info)) {
+    return RMW_RET_OK;
+  }
+
+  // The queue and the conflater gather the fragments straight into their own buffers.
+  if (publisher_info->conflating_publisher_) {
+    return publisher_info->conflating_publisher_->push_fragments(
+      fragments, fragment_count, total_length);
+  }
+  if (publisher_info->deferred_queue_) {
+    return publisher_info->deferred_queue_->push_fragments(
+      fragments, fragment_count, total_length);
+  }
+
+  std::lock_guard<std::mutex> lock(publisher_info->publish_mutex_);
+  if (fragment_count == 1) {
+    // A single fragment is contiguous already, the sample only reads the loaned buffer.
+    rcutils_uint8_array_t fragment = rcutils_get_zero_initialized_uint8_array();
+    fragment.buffer = const_cast<uint8_t *>(fragments[0].buffer);
+    fragment.buffer_length = fragments[0].length;
+    fragment.buffer_capacity = fragments[0].length;
+    if (!publish(data_writer, instance, &fragment)) {
+      RMW_SET_ERROR_MSG("failed to publish message");
+      return RMW_RET_ERROR;
+    }
+    return RMW_RET_OK;
+  }
+  // The serialized data type can only loan a contiguous buffer, so the fragments are
+  // gathered into a buffer of the publisher which is reused across calls.
+  rcutils_uint8_array_t * gather_buffer = &publisher_info->gather_buffer_;
+  rmw_ret_t ret = gather_fragments(fragments, fragment_count, total_length, gather_buffer);
+  if (ret != RMW_RET_OK) {
+    return ret;
+  }
+  if (!publish(data_writer, instance, gather_buffer)) {
+    RMW_SET_ERROR_MSG("failed to publish message");
+    return RMW_RET_ERROR;
+  }
+  return RMW_RET_OK;
+}
+
+}  // namespace rmw_connext_cpp
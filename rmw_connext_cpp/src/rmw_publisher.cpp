@@ -12,6 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <chrono>
+#include <cstddef>
+#include <limits>
+#include <new>
 #include <string>
 
 #include "rmw/allocators.h"
@@ -21,10 +25,15 @@
 #include "rmw/types.h"
 
 #include "rmw_connext_shared_cpp/qos.hpp"
+#include "rmw_connext_shared_cpp/type_code.hpp"
 #include "rmw_connext_shared_cpp/types.hpp"
+#include "rmw_connext_shared_cpp/wait_set.hpp"
 
 #include "rmw_connext_cpp/identifier.hpp"
+#include "rmw_connext_cpp/publisher_options.hpp"
 
+#include "conflating_publisher.hpp"
+#include "deferred_publish_queue.hpp"
 #include "process_topic_and_service_names.hpp"
 #include "type_support_common.hpp"
 #include "rmw_connext_cpp/connext_static_publisher_info.hpp"
@@ -37,29 +46,178 @@
 //   rmw_connext_shared_cpp/shared_functions.cpp
 // #define DISCOVERY_DEBUG_LOGGING 1
 
+// Allocator functions of ConnextStaticPublisherAllocation::cdr_stream_.
+// The buffer is owned by the allocation, so releasing it is a no-op and any attempt
+// to get more memory is recorded in the exhausted_ flag passed as state instead.
+static void *
+exhausted_allocate(size_t size, void * state)
+{
+  (void) size;
+  *static_cast<bool *>(state) = true;
+  return nullptr;
+}
+
+static void *
+exhausted_reallocate(void * pointer, size_t size, void * state)
+{
+  (void) pointer;
+  (void) size;
+  *static_cast<bool *>(state) = true;
+  return nullptr;
+}
+
+static void *
+exhausted_zero_allocate(size_t number_of_elements, size_t size_of_element, void * state)
+{
+  (void) number_of_elements;
+  (void) size_of_element;
+  *static_cast<bool *>(state) = true;
+  return nullptr;
+}
+
+static void
+noop_deallocate(void * pointer, void * state)
+{
+  (void) pointer;
+  (void) state;
+}
+
+// Write the pending messages of the deferred publish queue and the conflating
+// publisher and destroy them.
+static void
+destroy_publisher_threads(ConnextStaticPublisherInfo * publisher_info)
+{
+  DeferredPublishQueue * deferred_queue = publisher_info->deferred_queue_;
+  if (deferred_queue) {
+    RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+      deferred_queue->~DeferredPublishQueue(), DeferredPublishQueue)
+    rmw_free(deferred_queue);
+    publisher_info->deferred_queue_ = nullptr;
+  }
+  ConflatingPublisher * conflating_publisher = publisher_info->conflating_publisher_;
+  if (conflating_publisher) {
+    RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+      conflating_publisher->~ConflatingPublisher(), ConflatingPublisher)
+    rmw_free(conflating_publisher);
+    publisher_info->conflating_publisher_ = nullptr;
+  }
+}
+
 extern "C"
 {
 rmw_ret_t
 rmw_init_publisher_allocation(
-  const rosidl_message_type_support_t * type_support,
+  const rosidl_message_type_support_t * type_supports,
   const rosidl_message_bounds_t * message_bounds,
   rmw_publisher_allocation_t * allocation)
 {
-  // Unused in current implementation.
-  (void) type_support;
+  // rosidl_message_bounds_t doesn't carry any bounds yet,
+  // the largest sample is derived from the type code instead.
   (void) message_bounds;
-  (void) allocation;
-  RMW_SET_ERROR_MSG("unimplemented");
+  if (!allocation) {
+    RMW_SET_ERROR_MSG("allocation handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  RMW_CONNEXT_EXTRACT_MESSAGE_TYPESUPPORT(type_supports, type_support, RMW_RET_ERROR)
+
+  const message_type_support_callbacks_t * callbacks =
+    static_cast<const message_type_support_callbacks_t *>(type_support->data);
+  if (!callbacks) {
+    RMW_SET_ERROR_MSG("callbacks handle is null");
+    return RMW_RET_ERROR;
+  }
+  size_t max_size = 0;
+  if (!get_serialized_sample_max_size(callbacks->get_type_code(), max_size)) {
+    RMW_SET_ERROR_MSG("publisher allocations are only supported for bounded message types");
+    return RMW_RET_UNSUPPORTED;
+  }
+
+  ConnextStaticPublisherAllocation * allocation_info = nullptr;
+  ConnextStaticSerializedData * instance = nullptr;
+  uint8_t * buffer = nullptr;
+  void * buf = nullptr;
+
+  instance = ConnextStaticSerializedDataTypeSupport::create_data();
+  if (!instance) {
+    RMW_SET_ERROR_MSG("failed to create dds message instance");
+    goto fail;
+  }
+  // the sample only ever loans the buffer being published
+  instance->serialized_data.maximum(0);
+
+  buffer = static_cast<uint8_t *>(rmw_allocate(max_size));
+  if (!buffer) {
+    RMW_SET_ERROR_MSG("failed to allocate memory for the serialization buffer");
+    goto fail;
+  }
+
+  buf = rmw_allocate(sizeof(ConnextStaticPublisherAllocation));
+  if (!buf) {
+    RMW_SET_ERROR_MSG("failed to allocate memory");
+    goto fail;
+  }
+  // Use a placement new to construct the ConnextStaticPublisherAllocation in the preallocated buffer.
+  RMW_TRY_PLACEMENT_NEW(
+    allocation_info, buf, goto fail, ConnextStaticPublisherAllocation, )
+  buf = nullptr;  // Only free the allocation_info pointer; don't need the buf pointer anymore.
+  allocation_info->callbacks_ = callbacks;
+  allocation_info->instance_ = instance;
+  allocation_info->buffer_ = buffer;
+  allocation_info->buffer_capacity_ = max_size;
+  allocation_info->cdr_stream_ = rcutils_get_zero_initialized_uint8_array();
+  allocation_info->cdr_stream_.allocator.allocate = exhausted_allocate;
+  allocation_info->cdr_stream_.allocator.deallocate = noop_deallocate;
+  allocation_info->cdr_stream_.allocator.reallocate = exhausted_reallocate;
+  allocation_info->cdr_stream_.allocator.zero_allocate = exhausted_zero_allocate;
+  allocation_info->cdr_stream_.allocator.state = &allocation_info->exhausted_;
+  allocation_info->exhausted_ = false;
+
+  allocation->implementation_identifier = rti_connext_identifier;
+  allocation->data = allocation_info;
+  return RMW_RET_OK;
+
+fail:
+  if (instance) {
+    ConnextStaticSerializedDataTypeSupport::delete_data(instance);
+  }
+  rmw_free(buffer);
+  if (allocation_info) {
+    RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+      allocation_info->~ConnextStaticPublisherAllocation(), ConnextStaticPublisherAllocation)
+    rmw_free(allocation_info);
+  }
+  if (buf) {
+    rmw_free(buf);
+  }
   return RMW_RET_ERROR;
 }
 
 rmw_ret_t
 rmw_fini_publisher_allocation(rmw_publisher_allocation_t * allocation)
 {
-  // Unused in current implementation.
-  (void) allocation;
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_ERROR;
+  if (!allocation) {
+    RMW_SET_ERROR_MSG("allocation handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    publisher allocation,
+    allocation->implementation_identifier, rti_connext_identifier,
+    return RMW_RET_ERROR)
+
+  auto allocation_info = static_cast<ConnextStaticPublisherAllocation *>(allocation->data);
+  if (allocation_info) {
+    if (allocation_info->instance_) {
+      ConnextStaticSerializedDataTypeSupport::delete_data(allocation_info->instance_);
+    }
+    rmw_free(allocation_info->buffer_);
+    RMW_TRY_DESTRUCTOR(
+      allocation_info->~ConnextStaticPublisherAllocation(),
+      ConnextStaticPublisherAllocation, return RMW_RET_ERROR)
+    rmw_free(allocation_info);
+  }
+  allocation->implementation_identifier = nullptr;
+  allocation->data = nullptr;
+  return RMW_RET_OK;
 }
 
 rmw_publisher_t *
@@ -113,6 +271,41 @@ rmw_create_publisher(
     RMW_SET_ERROR_MSG("callbacks handle is null");
     return NULL;
   }
+  rmw_connext_cpp::PublisherOptions options = rmw_connext_cpp::get_default_publisher_options();
+  if (publisher_options->rmw_specific_publisher_payload) {
+    options = *static_cast<const rmw_connext_cpp::PublisherOptions *>(
+      publisher_options->rmw_specific_publisher_payload);
+  }
+  ConnextDataWriterQosOptions datawriter_qos_options;
+  switch (options.publish_mode) {
+    case rmw_connext_cpp::PublishMode::synchronous:
+      datawriter_qos_options.publish_mode = ConnextPublishMode::synchronous;
+      break;
+    case rmw_connext_cpp::PublishMode::asynchronous:
+      datawriter_qos_options.publish_mode = ConnextPublishMode::asynchronous;
+      break;
+    default:
+      datawriter_qos_options.publish_mode = ConnextPublishMode::automatic;
+      break;
+  }
+  // Unbounded types keep max_serialized_size at 0 and are published asynchronously.
+  if (
+    !get_serialized_sample_max_size(
+      callbacks->get_type_code(), datawriter_qos_options.max_serialized_size))
+  {
+    datawriter_qos_options.max_serialized_size = 0;
+  }
+  datawriter_qos_options.batch_enable = options.batch_enable;
+  datawriter_qos_options.batch_max_samples = options.batch_max_samples;
+  datawriter_qos_options.batch_max_data_bytes = options.batch_max_bytes;
+  datawriter_qos_options.batch_max_flush_delay = options.batch_max_flush_delay;
+  if (
+    options.deferred_queue_depth > 0 &&
+    (options.conflation_interval.sec != 0 || options.conflation_interval.nsec != 0))
+  {
+    RMW_SET_ERROR_MSG("conflation can't be combined with a deferred publish queue");
+    return NULL;
+  }
   std::string type_name = _create_type_name(callbacks);
   // Past this point, a failure results in unrolling code in the goto fail block.
   DDS::TypeCode * type_code = nullptr;
@@ -121,6 +314,9 @@ rmw_create_publisher(
   DDS::ReturnCode_t status;
   DDS::Publisher * dds_publisher = nullptr;
   DDS::DataWriter * topic_writer = nullptr;
+  bool writer_registered = false;
+  ConnextStaticSerializedDataDataWriter * data_writer = nullptr;
+  ConnextStaticSerializedData * instance = nullptr;
   DDS::Topic * topic = nullptr;
   DDS::TopicDescription * topic_description = nullptr;
   void * info_buf = nullptr;
@@ -218,7 +414,7 @@ rmw_create_publisher(
   DDS::String_free(topic_str);
   topic_str = nullptr;
 
-  if (!get_datawriter_qos(participant, *qos_profile, datawriter_qos)) {
+  if (!get_datawriter_qos(participant, *qos_profile, datawriter_qos_options, datawriter_qos)) {
     // error string was set within the function
     goto fail;
   }
@@ -229,6 +425,27 @@ rmw_create_publisher(
     RMW_SET_ERROR_MSG("failed to create datawriter");
     goto fail;
   }
+  // ignored right away if subscriptions of the node on the topic asked for it
+  node_info->local_publication_filter.add_writer(
+    participant, topic_writer->get_topic()->get_name(), topic_writer->get_instance_handle());
+  writer_registered = true;
+
+  data_writer = ConnextStaticSerializedDataDataWriter::narrow(topic_writer);
+  if (!data_writer) {
+    RMW_SET_ERROR_MSG("failed to narrow data writer");
+    goto fail;
+  }
+
+  instance = ConnextStaticSerializedDataTypeSupport::create_data();
+  if (!instance) {
+    RMW_SET_ERROR_MSG("failed to create dds message instance");
+    goto fail;
+  }
+  // The sample never owns memory, rmw_publish() loans the serialized message into it.
+  if (!instance->serialized_data.maximum(0)) {
+    RMW_SET_ERROR_MSG("failed to release memory of dds message instance");
+    goto fail;
+  }
 
   // Allocate memory for the ConnextStaticPublisherInfo object.
   info_buf = rmw_allocate(sizeof(ConnextStaticPublisherInfo));
@@ -241,7 +458,88 @@ rmw_create_publisher(
   info_buf = nullptr;  // Only free the publisher_info pointer; don't need the buf pointer anymore.
   publisher_info->dds_publisher_ = dds_publisher;
   publisher_info->topic_writer_ = topic_writer;
+  publisher_info->data_writer_ = data_writer;
+  publisher_info->instance_ = instance;
+  instance = nullptr;
   publisher_info->callbacks_ = callbacks;
+  // Skipping would lose messages late joiners expect to receive for any other durability.
+  publisher_info->skip_when_unmatched_ = options.skip_when_unmatched &&
+    datawriter_qos.durability.kind == DDS::VOLATILE_DURABILITY_QOS;
+  publisher_info->skipped_unmatched_ = 0;
+  publisher_info->cdr_stream_ = rcutils_get_zero_initialized_uint8_array();
+  publisher_info->cdr_stream_.allocator = rcutils_get_default_allocator();
+  publisher_info->gather_buffer_ = rcutils_get_zero_initialized_uint8_array();
+  publisher_info->gather_buffer_.allocator = rcutils_get_default_allocator();
+  publisher_info->deferred_queue_ = nullptr;
+  if (options.deferred_queue_depth > 0) {
+    // Preallocate the slots unless the type is unbounded or its messages are huge.
+    size_t slot_capacity = datawriter_qos_options.max_serialized_size;
+    if (slot_capacity > ConnextStaticPublisherInfo::max_cached_cdr_stream_capacity) {
+      slot_capacity = 0;
+    }
+    void * queue_buf = rmw_allocate(sizeof(DeferredPublishQueue));
+    if (!queue_buf) {
+      RMW_SET_ERROR_MSG("failed to allocate memory for deferred publish queue");
+      goto fail;
+    }
+    RMW_TRY_PLACEMENT_NEW(
+      publisher_info->deferred_queue_, queue_buf, rmw_free(queue_buf); goto fail,
+      DeferredPublishQueue, data_writer, options.deferred_queue_depth, slot_capacity,
+      options.deferred_overflow_policy)
+    if (!publisher_info->deferred_queue_->start()) {
+      // error string was set within the function
+      goto fail;
+    }
+  }
+  publisher_info->conflating_publisher_ = nullptr;
+  if (options.conflation_interval.sec != 0 || options.conflation_interval.nsec != 0) {
+    void * conflating_buf = rmw_allocate(sizeof(ConflatingPublisher));
+    if (!conflating_buf) {
+      RMW_SET_ERROR_MSG("failed to allocate memory for conflating publisher");
+      goto fail;
+    }
+    RMW_TRY_PLACEMENT_NEW(
+      publisher_info->conflating_publisher_, conflating_buf, rmw_free(conflating_buf); goto fail,
+      ConflatingPublisher, data_writer,
+      std::chrono::seconds(options.conflation_interval.sec) +
+      std::chrono::nanoseconds(options.conflation_interval.nsec))
+    if (!publisher_info->conflating_publisher_->start()) {
+      // error string was set within the function
+      goto fail;
+    }
+  }
+  publisher_info->loan_pool_ = nullptr;
+  publisher_info->loan_pool_size_ = 0;
+  publisher_info->loan_message_size_ = 0;
+  {
+    size_t loan_message_size = 0;
+    size_t loan_alignment = 0;
+    if (
+      options.loan_pool_size > 0 &&
+      get_plain_type_layout(type_code, loan_message_size, loan_alignment) &&
+      loan_alignment <= alignof(std::max_align_t) &&
+      options.loan_pool_size <= (std::numeric_limits<size_t>::max)() / loan_message_size)
+    {
+      publisher_info->loan_pool_ = static_cast<uint8_t *>(
+        rmw_allocate(options.loan_pool_size * loan_message_size));
+      if (!publisher_info->loan_pool_) {
+        RMW_SET_ERROR_MSG("failed to allocate memory for loaned messages");
+        goto fail;
+      }
+      publisher_info->loan_pool_size_ = options.loan_pool_size;
+      publisher_info->loan_message_size_ = loan_message_size;
+      try {
+        publisher_info->loan_free_.reserve(options.loan_pool_size);
+      } catch (const std::bad_alloc &) {
+        RMW_SET_ERROR_MSG("failed to allocate memory for loaned messages");
+        goto fail;
+      }
+      for (size_t i = 0; i < options.loan_pool_size; ++i) {
+        publisher_info->loan_free_.push_back(publisher_info->loan_pool_ + i * loan_message_size);
+      }
+      publisher->can_loan_messages = true;
+    }
+  }
   publisher_info->publisher_gid.implementation_identifier = rti_connext_identifier;
   publisher_info->listener_ = publisher_listener;
   publisher_listener = nullptr;
@@ -292,6 +590,10 @@ rmw_create_publisher(
 
   return publisher;
 fail:
+  if (publisher_info) {
+    // stop the writer threads before the data writer goes away
+    destroy_publisher_threads(publisher_info);
+  }
   if (topic_str) {
     DDS::String_free(topic_str);
     topic_str = nullptr;
@@ -299,6 +601,13 @@ fail:
   if (publisher) {
     rmw_publisher_free(publisher);
   }
+  if (instance) {
+    ConnextStaticSerializedDataTypeSupport::delete_data(instance);
+  }
+  if (writer_registered) {
+    node_info->local_publication_filter.remove_writer(
+      topic_writer->get_topic()->get_name(), topic_writer->get_instance_handle());
+  }
   if (dds_publisher) {
     if (topic_writer) {
       if (dds_publisher->delete_datawriter(topic_writer) != DDS::RETCODE_OK) {
@@ -321,6 +630,10 @@ fail:
     rmw_free(publisher_listener);
   }
   if (publisher_info) {
+    if (publisher_info->instance_) {
+      ConnextStaticSerializedDataTypeSupport::delete_data(publisher_info->instance_);
+    }
+    rmw_free(publisher_info->loan_pool_);
     if (publisher_info->listener_) {
       RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
         publisher_info->listener_->~ConnextPublisherListener(), ConnextPublisherListener)
@@ -426,15 +739,41 @@ rmw_publisher_assert_liveliness(const rmw_publisher_t * publisher)
 rmw_ret_t
 rmw_borrow_loaned_message(
   const rmw_publisher_t * publisher,
-  const rosidl_message_type_support_t * type_support,
+  const rosidl_message_type_support_t * type_supports,
   void ** ros_message)
 {
-  (void) publisher;
-  (void) type_support;
-  (void) ros_message;
+  RMW_CHECK_ARGUMENT_FOR_NULL(publisher, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    publisher handle,
+    publisher->implementation_identifier, rti_connext_identifier,
+    return RMW_RET_ERROR)
+  RMW_CHECK_ARGUMENT_FOR_NULL(ros_message, RMW_RET_INVALID_ARGUMENT);
+  if (*ros_message) {
+    RMW_SET_ERROR_MSG("ros message pointer is not null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  RMW_CONNEXT_EXTRACT_MESSAGE_TYPESUPPORT(type_supports, type_support, RMW_RET_ERROR)
+
+  auto info = static_cast<ConnextStaticPublisherInfo *>(publisher->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("publisher internal data is invalid");
+    return RMW_RET_ERROR;
+  }
+  if (!info->loan_pool_) {
+    RMW_SET_ERROR_MSG("publisher can not loan messages");
+    return RMW_RET_UNSUPPORTED;
+  }
+  if (type_support->data != info->callbacks_) {
+    RMW_SET_ERROR_MSG("type support does not match the message type of the publisher");
+    return RMW_RET_ERROR;
+  }
 
-  RMW_SET_ERROR_MSG("rmw_borrow_loaned_message not implemented for rmw_connext_cpp");
-  return RMW_RET_UNSUPPORTED;
+  *ros_message = info->borrow_loaned_message();
+  if (!*ros_message) {
+    RMW_SET_ERROR_MSG("all loaned messages of the publisher are in use");
+    return RMW_RET_ERROR;
+  }
+  return RMW_RET_OK;
 }
 
 rmw_ret_t
@@ -442,12 +781,23 @@ rmw_return_loaned_message_from_publisher(
   const rmw_publisher_t * publisher,
   void * loaned_message)
 {
-  (void) publisher;
-  (void) loaned_message;
+  RMW_CHECK_ARGUMENT_FOR_NULL(publisher, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    publisher handle,
+    publisher->implementation_identifier, rti_connext_identifier,
+    return RMW_RET_ERROR)
+  RMW_CHECK_ARGUMENT_FOR_NULL(loaned_message, RMW_RET_INVALID_ARGUMENT);
 
-  RMW_SET_ERROR_MSG(
-    "rmw_return_loaned_message_from_publisher not implemented for rmw_connext_cpp");
-  return RMW_RET_UNSUPPORTED;
+  auto info = static_cast<ConnextStaticPublisherInfo *>(publisher->data);
+  if (!info) {
+    RMW_SET_ERROR_MSG("publisher internal data is invalid");
+    return RMW_RET_ERROR;
+  }
+  if (!info->return_loaned_message(loaned_message)) {
+    RMW_SET_ERROR_MSG("message is not loaned from this publisher");
+    return RMW_RET_ERROR;
+  }
+  return RMW_RET_OK;
 }
 
 rmw_ret_t
@@ -490,13 +840,22 @@ rmw_destroy_publisher(rmw_node_t * node, rmw_publisher_t * publisher)
     node_info->publisher_listener->trigger_graph_guard_condition();
     DDS::Publisher * dds_publisher = publisher_info->dds_publisher_;
 
+    // Writes the pending messages, so it has to happen before the data writer is deleted.
+    destroy_publisher_threads(publisher_info);
+
     if (dds_publisher) {
       if (publisher_info->topic_writer_) {
+        // the status condition stays attached to the wait sets which waited on it last
+        detach_from_wait_sets(publisher_info->topic_writer_->get_statuscondition());
+        node_info->local_publication_filter.remove_writer(
+          publisher_info->topic_writer_->get_topic()->get_name(),
+          publisher_info->topic_writer_->get_instance_handle());
         if (dds_publisher->delete_datawriter(publisher_info->topic_writer_) != DDS::RETCODE_OK) {
           RMW_SET_ERROR_MSG("failed to delete datawriter");
           return RMW_RET_ERROR;
         }
         publisher_info->topic_writer_ = nullptr;
+        publisher_info->data_writer_ = nullptr;
       }
       if (participant->delete_publisher(dds_publisher) != DDS::RETCODE_OK) {
         RMW_SET_ERROR_MSG("failed to delete publisher");
@@ -508,6 +867,21 @@ rmw_destroy_publisher(rmw_node_t * node, rmw_publisher_t * publisher)
       return RMW_RET_ERROR;
     }
 
+    if (publisher_info->instance_) {
+      ConnextStaticSerializedDataTypeSupport::delete_data(publisher_info->instance_);
+      publisher_info->instance_ = nullptr;
+    }
+    for (rcutils_uint8_array_t * buffer :
+      {&publisher_info->cdr_stream_, &publisher_info->gather_buffer_})
+    {
+      if (buffer->buffer) {
+        buffer->allocator.deallocate(buffer->buffer, buffer->allocator.state);
+        buffer->buffer = nullptr;
+      }
+    }
+    rmw_free(publisher_info->loan_pool_);
+    publisher_info->loan_pool_ = nullptr;
+
     ConnextPublisherListener * pub_listener = publisher_info->listener_;
     if (pub_listener) {
       RMW_TRY_DESTRUCTOR(
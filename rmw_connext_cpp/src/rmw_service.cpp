@@ -20,6 +20,8 @@
 
 #include "rmw_connext_shared_cpp/qos.hpp"
 #include "rmw_connext_shared_cpp/types.hpp"
+#include "rmw_connext_shared_cpp/wait_notifier.hpp"
+#include "rmw_connext_shared_cpp/wait_set.hpp"
 
 #include "rmw_connext_cpp/identifier.hpp"
 #include "process_topic_and_service_names.hpp"
@@ -85,6 +87,7 @@ rmw_create_service(
   DDS::DataReader * request_datareader = nullptr;
   DDS::DataWriter * response_datawriter = nullptr;
   DDS::ReadCondition * read_condition = nullptr;
+  ConnextWaitNotifier * wait_notifier = nullptr;
   void * replier = nullptr;
   void * buf = nullptr;
   ConnextStaticServiceInfo * service_info = nullptr;
@@ -154,6 +157,18 @@ rmw_create_service(
     goto fail;
   }
 
+  wait_notifier = create_wait_notifier();
+  if (!wait_notifier) {
+    // error string was set within the function
+    goto fail;
+  }
+  // only notifies epoll wait sets of arriving requests
+  status = request_datareader->set_listener(wait_notifier, DDS::DATA_AVAILABLE_STATUS);
+  if (status != DDS::RETCODE_OK) {
+    RMW_SET_ERROR_MSG("failed to set datareader listener");
+    goto fail;
+  }
+
   dds_subscriber = request_datareader->get_subscriber();
   status = participant->get_default_subscriber_qos(subscriber_qos);
   if (status != DDS::RETCODE_OK) {
@@ -187,6 +202,7 @@ rmw_create_service(
   service_info->callbacks_ = callbacks;
   service_info->request_datareader_ = request_datareader;
   service_info->read_condition_ = read_condition;
+  service_info->wait_notifier_ = wait_notifier;
 
   service->implementation_identifier = rti_connext_identifier;
   service->data = service_info;
@@ -240,6 +256,13 @@ fail:
   if (service) {
     rmw_service_free(service);
   }
+  // the listener has to be removed before the notifier goes
+  if (wait_notifier) {
+    if (request_datareader) {
+      request_datareader->set_listener(nullptr, DDS::STATUS_MASK_NONE);
+    }
+    destroy_wait_notifier(wait_notifier);
+  }
   if (request_datareader) {
     if (read_condition) {
       if (request_datareader->delete_readcondition(read_condition) != DDS::RETCODE_OK) {
@@ -311,6 +334,8 @@ rmw_destroy_service(rmw_node_t * node, rmw_service_t * service)
     if (request_datareader) {
       auto read_condition = service_info->read_condition_;
       if (read_condition) {
+        // the condition stays attached to the wait sets which waited on it last
+        detach_from_wait_sets(read_condition);
         if (request_datareader->delete_readcondition(read_condition) != DDS::RETCODE_OK) {
           RMW_SET_ERROR_MSG("failed to delete readcondition");
           result = RMW_RET_ERROR;
@@ -321,6 +346,17 @@ rmw_destroy_service(rmw_node_t * node, rmw_service_t * service)
       RMW_SET_ERROR_MSG("cannot delete readcondition because the datareader is null");
       result = RMW_RET_ERROR;
     }
+    if (service_info->wait_notifier_) {
+      if (
+        request_datareader &&
+        request_datareader->set_listener(nullptr, DDS::STATUS_MASK_NONE) != DDS::RETCODE_OK)
+      {
+        RMW_SET_ERROR_MSG("failed to unset datareader listener");
+        result = RMW_RET_ERROR;
+      }
+      destroy_wait_notifier(service_info->wait_notifier_);
+      service_info->wait_notifier_ = nullptr;
+    }
     const service_type_support_callbacks_t * callbacks = service_info->callbacks_;
     if (callbacks) {
       if (service_info->replier_) {
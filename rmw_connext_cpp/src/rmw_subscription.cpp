@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <cstdint>
 #include <string>
 
 #include "rmw/allocators.h"
@@ -20,11 +22,16 @@
 #include "rmw/rmw.h"
 
 #include "rmw_connext_shared_cpp/qos.hpp"
+#include "rmw_connext_shared_cpp/type_code.hpp"
 #include "rmw_connext_shared_cpp/types.hpp"
+#include "rmw_connext_shared_cpp/wait_notifier.hpp"
+#include "rmw_connext_shared_cpp/wait_set.hpp"
 
 #include "rmw_connext_cpp/identifier.hpp"
+#include "rmw_connext_cpp/subscription_options.hpp"
 
 #include "process_topic_and_service_names.hpp"
+#include "subscription_push_queue.hpp"
 #include "type_support_common.hpp"
 #include "rmw_connext_cpp/connext_static_subscriber_info.hpp"
 
@@ -36,29 +43,125 @@
 //   rmw_connext_shared_cpp/shared_functions.cpp
 // #define DISCOVERY_DEBUG_LOGGING 1
 
+// Connext supports at most 100 parameters in a filter expression.
+static constexpr size_t max_filter_parameters = 100;
+
+// Return a name for a content filtered topic which is unique within the process.
+static std::string
+create_content_filtered_topic_name()
+{
+  static std::atomic<uint64_t> count{0};
+  return "rmw_connext_filter_" + std::to_string(count++);
+}
+
 extern "C"
 {
 rmw_ret_t
 rmw_init_subscription_allocation(
-  const rosidl_message_type_support_t * type_support,
+  const rosidl_message_type_support_t * type_supports,
   const rosidl_message_bounds_t * message_bounds,
   rmw_subscription_allocation_t * allocation)
 {
-  // Unused in current implementation.
-  (void) type_support;
+  // Messages are converted straight from the loaned sample,
+  // so no serialization buffer has to be sized from the bounds.
   (void) message_bounds;
-  (void) allocation;
-  RMW_SET_ERROR_MSG("unimplemented");
+  if (!allocation) {
+    RMW_SET_ERROR_MSG("allocation handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  RMW_CONNEXT_EXTRACT_MESSAGE_TYPESUPPORT(type_supports, type_support, RMW_RET_ERROR)
+
+  const message_type_support_callbacks_t * callbacks =
+    static_cast<const message_type_support_callbacks_t *>(type_support->data);
+  if (!callbacks) {
+    RMW_SET_ERROR_MSG("callbacks handle is null");
+    return RMW_RET_ERROR;
+  }
+
+  ConnextStaticSubscriptionAllocation * allocation_info = nullptr;
+  ConnextStaticSerializedDataSeq * dds_messages = nullptr;
+  DDS::SampleInfoSeq * sample_infos = nullptr;
+  void * buf = nullptr;
+
+  buf = rmw_allocate(sizeof(ConnextStaticSerializedDataSeq));
+  if (!buf) {
+    RMW_SET_ERROR_MSG("failed to allocate memory");
+    goto fail;
+  }
+  RMW_TRY_PLACEMENT_NEW(dds_messages, buf, goto fail, ConnextStaticSerializedDataSeq, )
+  buf = rmw_allocate(sizeof(DDS::SampleInfoSeq));
+  if (!buf) {
+    RMW_SET_ERROR_MSG("failed to allocate memory");
+    goto fail;
+  }
+  RMW_TRY_PLACEMENT_NEW(sample_infos, buf, goto fail, DDS::SampleInfoSeq, )
+  buf = rmw_allocate(sizeof(ConnextStaticSubscriptionAllocation));
+  if (!buf) {
+    RMW_SET_ERROR_MSG("failed to allocate memory");
+    goto fail;
+  }
+  RMW_TRY_PLACEMENT_NEW(
+    allocation_info, buf, goto fail, ConnextStaticSubscriptionAllocation, )
+  buf = nullptr;  // Only free the allocation_info pointer; don't need the buf pointer anymore.
+  allocation_info->callbacks_ = callbacks;
+  allocation_info->dds_messages_ = dds_messages;
+  allocation_info->sample_infos_ = sample_infos;
+
+  allocation->implementation_identifier = rti_connext_identifier;
+  allocation->data = allocation_info;
+  return RMW_RET_OK;
+
+fail:
+  if (dds_messages) {
+    RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+      dds_messages->~ConnextStaticSerializedDataSeq(), ConnextStaticSerializedDataSeq)
+    rmw_free(dds_messages);
+  }
+  if (sample_infos) {
+    RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+      sample_infos->~DDS_SampleInfoSeq(), DDS_SampleInfoSeq)
+    rmw_free(sample_infos);
+  }
+  if (buf) {
+    rmw_free(buf);
+  }
   return RMW_RET_ERROR;
 }
 
 rmw_ret_t
 rmw_fini_subscription_allocation(rmw_subscription_allocation_t * allocation)
 {
-  // Unused in current implementation.
-  (void) allocation;
-  RMW_SET_ERROR_MSG("unimplemented");
-  return RMW_RET_ERROR;
+  if (!allocation) {
+    RMW_SET_ERROR_MSG("allocation handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription allocation,
+    allocation->implementation_identifier, rti_connext_identifier,
+    return RMW_RET_ERROR)
+
+  auto allocation_info = static_cast<ConnextStaticSubscriptionAllocation *>(allocation->data);
+  if (allocation_info) {
+    if (allocation_info->dds_messages_) {
+      RMW_TRY_DESTRUCTOR(
+        allocation_info->dds_messages_->~ConnextStaticSerializedDataSeq(),
+        ConnextStaticSerializedDataSeq, return RMW_RET_ERROR)
+      rmw_free(allocation_info->dds_messages_);
+    }
+    if (allocation_info->sample_infos_) {
+      RMW_TRY_DESTRUCTOR(
+        allocation_info->sample_infos_->~DDS_SampleInfoSeq(),
+        DDS_SampleInfoSeq, return RMW_RET_ERROR)
+      rmw_free(allocation_info->sample_infos_);
+    }
+    RMW_TRY_DESTRUCTOR(
+      allocation_info->~ConnextStaticSubscriptionAllocation(),
+      ConnextStaticSubscriptionAllocation, return RMW_RET_ERROR)
+    rmw_free(allocation_info);
+  }
+  allocation->implementation_identifier = nullptr;
+  allocation->data = nullptr;
+  return RMW_RET_OK;
 }
 
 rmw_subscription_t *
@@ -116,6 +219,15 @@ rmw_create_subscription(
   DDS::Subscriber * dds_subscriber = nullptr;
   DDS::Topic * topic = nullptr;
   DDS::TopicDescription * topic_description = nullptr;
+  DDS::ContentFilteredTopic * content_filtered_topic = nullptr;
+  DDS::StringSeq filter_parameters;
+  ConnextDataReaderQosOptions datareader_qos_options;
+  ConnextWaitNotifier * wait_notifier = nullptr;
+  SubscriptionPushQueue * push_queue = nullptr;
+  void * push_queue_buf = nullptr;
+  size_t push_slot_capacity = 0;
+  rmw_connext_cpp::SubscriptionOptions options =
+    rmw_connext_cpp::get_default_subscription_options();
   DDS::DataReader * topic_reader = nullptr;
   DDS::ReadCondition * read_condition = nullptr;
   void * info_buf = nullptr;
@@ -124,6 +236,8 @@ rmw_create_subscription(
   ConnextStaticSubscriberInfo * subscriber_info = nullptr;
   rmw_subscription_t * subscription = nullptr;
   std::string mangled_name;
+  std::string dds_topic_name;
+  bool reader_registered = false;
 
   char * topic_str = nullptr;
 
@@ -178,6 +292,9 @@ rmw_create_subscription(
   RMW_TRY_PLACEMENT_NEW(subscriber_listener, listener_buf, goto fail, ConnextSubscriberListener, )
   listener_buf = nullptr;  // Only free the buffer pointer.
 
+  dds_topic_name = topic_str;
+  subscriber_listener->topic_name_ = dds_topic_name;
+
   dds_subscriber = participant->create_subscriber(
     subscriber_qos, subscriber_listener, DDS::SUBSCRIPTION_MATCHED_STATUS);
   if (!dds_subscriber) {
@@ -212,14 +329,84 @@ rmw_create_subscription(
   DDS::String_free(topic_str);
   topic_str = nullptr;
 
-  if (!get_datareader_qos(participant, *qos_profile, datareader_qos)) {
+  if (subscription_options->rmw_specific_subscription_payload) {
+    options = *static_cast<const rmw_connext_cpp::SubscriptionOptions *>(
+      subscription_options->rmw_specific_subscription_payload);
+  }
+  // Registered before the reader exists, so that it never matches writers due to be ignored.
+  subscriber_listener->ignore_local_writers_in_participant_ =
+    options.ignore_local_writers_in_participant;
+  node_info->local_publication_filter.add_reader(
+    participant, dds_topic_name, subscription_options->ignore_local_publications,
+    options.ignore_local_writers_in_participant);
+  reader_registered = true;
+  if (options.filter_expression && options.filter_expression[0] != '\0') {
+    if (options.filter_parameters_count > max_filter_parameters ||
+      (options.filter_parameters_count > 0 && !options.filter_parameters))
+    {
+      RMW_SET_ERROR_MSG("invalid filter parameters");
+      goto fail;
+    }
+    if (!filter_parameters.from_array(
+        const_cast<char **>(options.filter_parameters),
+        static_cast<DDS::Long>(options.filter_parameters_count)))
+    {
+      RMW_SET_ERROR_MSG("failed to copy filter parameters");
+      goto fail;
+    }
+    content_filtered_topic = participant->create_contentfilteredtopic(
+      create_content_filtered_topic_name().c_str(), topic,
+      options.filter_expression, filter_parameters);
+    if (!content_filtered_topic) {
+      RMW_SET_ERROR_MSG("failed to create content filtered topic");
+      goto fail;
+    }
+  }
+
+  datareader_qos_options.minimum_separation = options.minimum_separation;
+  if (!get_datareader_qos(participant, *qos_profile, datareader_qos_options, datareader_qos)) {
+    // error string was set within the function
+    goto fail;
+  }
+
+  wait_notifier = create_wait_notifier();
+  if (!wait_notifier) {
     // error string was set within the function
     goto fail;
   }
 
+  if (options.push_queue_depth > 0) {
+    // Preallocate buffers for messages fitting a datagram, larger ones are allocated on arrival.
+    if (
+      !get_serialized_sample_max_size(type_code, push_slot_capacity) ||
+      push_slot_capacity > connext_max_synchronous_sample_size)
+    {
+      push_slot_capacity = 0;
+    }
+    push_queue_buf = rmw_allocate(sizeof(SubscriptionPushQueue));
+    if (!push_queue_buf) {
+      RMW_SET_ERROR_MSG("failed to allocate memory for subscription push queue");
+      goto fail;
+    }
+    RMW_TRY_PLACEMENT_NEW(
+      push_queue, push_queue_buf, goto fail, SubscriptionPushQueue,
+      options.push_queue_depth, push_slot_capacity,
+      subscription_options->ignore_local_publications, wait_notifier)
+    push_queue_buf = nullptr;
+    if (!push_queue->init()) {
+      // error string was set within the function
+      goto fail;
+    }
+  }
+
+  // without a push queue, the listener only notifies epoll wait sets of arriving data
   topic_reader = dds_subscriber->create_datareader(
-    topic, datareader_qos,
-    NULL, DDS::STATUS_MASK_NONE);
+    content_filtered_topic ?
+    static_cast<DDS::TopicDescription *>(content_filtered_topic) : topic,
+    datareader_qos,
+    push_queue ?
+    static_cast<DDS::DataReaderListener *>(push_queue) : wait_notifier,
+    DDS::DATA_AVAILABLE_STATUS);
   if (!topic_reader) {
     RMW_SET_ERROR_MSG("failed to create datareader");
     goto fail;
@@ -243,10 +430,19 @@ rmw_create_subscription(
   info_buf = nullptr;  // Only free the subscriber_info pointer; don't need the buf pointer anymore.
   subscriber_info->dds_subscriber_ = dds_subscriber;
   subscriber_info->topic_reader_ = topic_reader;
+  subscriber_info->content_filtered_topic_ = content_filtered_topic;
+  content_filtered_topic = nullptr;
   subscriber_info->read_condition_ = read_condition;
+  subscriber_info->push_queue_ = push_queue;
+  subscriber_info->wait_condition_ = push_queue ?
+    static_cast<DDS::Condition *>(push_queue->get_condition()) : read_condition;
+  push_queue = nullptr;
+  subscriber_info->wait_notifier_ = wait_notifier;
+  wait_notifier = nullptr;
   subscriber_info->callbacks_ = callbacks;
   subscriber_info->listener_ = subscriber_listener;
   subscriber_listener = nullptr;
+  subscriber_info->serialized_loan_count_ = 0;
 
   subscription->implementation_identifier = rti_connext_identifier;
   subscription->data = subscriber_info;
@@ -262,8 +458,8 @@ rmw_create_subscription(
   subscription->options = *subscription_options;
 
   if (!qos_profile->avoid_ros_namespace_conventions) {
-    mangled_name =
-      topic_reader->get_topicdescription()->get_name();
+    // the reader's topic description may be the content filtered topic
+    mangled_name = dds_topic_name;
   } else {
     mangled_name = topic_name;
   }
@@ -318,6 +514,32 @@ fail:
       (std::cerr << ss.str()).flush();
     }
   }
+  if (subscriber_info && subscriber_info->content_filtered_topic_) {
+    content_filtered_topic = subscriber_info->content_filtered_topic_;
+  }
+  if (subscriber_info && subscriber_info->push_queue_) {
+    push_queue = subscriber_info->push_queue_;
+  }
+  if (push_queue) {
+    RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+      push_queue->~SubscriptionPushQueue(), SubscriptionPushQueue)
+    rmw_free(push_queue);
+  }
+  if (push_queue_buf) {
+    rmw_free(push_queue_buf);
+  }
+  if (subscriber_info && subscriber_info->wait_notifier_) {
+    wait_notifier = subscriber_info->wait_notifier_;
+  }
+  destroy_wait_notifier(wait_notifier);
+  if (content_filtered_topic) {
+    if (participant->delete_contentfilteredtopic(content_filtered_topic) != DDS::RETCODE_OK) {
+      std::stringstream ss;
+      ss << "leaking content filtered topic while handling failure at " <<
+        __FILE__ << ":" << __LINE__ << '\n';
+      (std::cerr << ss.str()).flush();
+    }
+  }
   if (subscriber_listener) {
     RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
       subscriber_listener->~ConnextSubscriberListener(), ConnextSubscriberListener)
@@ -339,6 +561,11 @@ fail:
   if (listener_buf) {
     rmw_free(listener_buf);
   }
+  if (reader_registered) {
+    node_info->local_publication_filter.remove_reader(
+      dds_topic_name, subscription_options->ignore_local_publications,
+      options.ignore_local_writers_in_participant);
+  }
 
   return NULL;
 }
@@ -446,6 +673,20 @@ rmw_destroy_subscription(rmw_node_t * node, rmw_subscription_t * subscription)
     if (dds_subscriber) {
       auto topic_reader = subscriber_info->topic_reader_;
       if (topic_reader) {
+        if (subscriber_info->listener_) {
+          node_info->local_publication_filter.remove_reader(
+            subscriber_info->listener_->topic_name_,
+            subscription->options.ignore_local_publications,
+            subscriber_info->listener_->ignore_local_writers_in_participant_);
+        }
+        if (subscriber_info->return_serialized_loans() != RMW_RET_OK) {
+          result = RMW_RET_ERROR;
+        }
+        // conditions stay attached to the wait sets which waited on them last
+        if (subscriber_info->wait_condition_) {
+          detach_from_wait_sets(subscriber_info->wait_condition_);
+        }
+        detach_from_wait_sets(topic_reader->get_statuscondition());
         auto read_condition = subscriber_info->read_condition_;
         if (read_condition) {
           if (topic_reader->delete_readcondition(read_condition) != DDS::RETCODE_OK) {
@@ -472,6 +713,28 @@ rmw_destroy_subscription(rmw_node_t * node, rmw_subscription_t * subscription)
       RMW_SET_ERROR_MSG("cannot delete datareader because the subscriber is null");
       result = RMW_RET_ERROR;
     }
+    // the push queue is the reader's listener, it can only go once the reader is deleted
+    if (subscriber_info->push_queue_ && !subscriber_info->topic_reader_) {
+      RMW_TRY_DESTRUCTOR(
+        subscriber_info->push_queue_->~SubscriptionPushQueue(),
+        SubscriptionPushQueue, result = RMW_RET_ERROR)
+      rmw_free(subscriber_info->push_queue_);
+      subscriber_info->push_queue_ = nullptr;
+    }
+    // so is the notifier
+    if (subscriber_info->wait_notifier_ && !subscriber_info->topic_reader_) {
+      destroy_wait_notifier(subscriber_info->wait_notifier_);
+      subscriber_info->wait_notifier_ = nullptr;
+    }
+    if (subscriber_info->content_filtered_topic_ && !subscriber_info->topic_reader_) {
+      if (participant->delete_contentfilteredtopic(
+          subscriber_info->content_filtered_topic_) != DDS::RETCODE_OK)
+      {
+        RMW_SET_ERROR_MSG("failed to delete content filtered topic");
+        result = RMW_RET_ERROR;
+      }
+      subscriber_info->content_filtered_topic_ = nullptr;
+    }
     RMW_TRY_DESTRUCTOR(
       subscriber_info->~ConnextStaticSubscriberInfo(),
       ConnextStaticSubscriberInfo, result = RMW_RET_ERROR)
@@ -486,3 +749,86 @@ rmw_destroy_subscription(rmw_node_t * node, rmw_subscription_t * subscription)
   return result;
 }
 }  // extern "C"
+
+namespace rmw_connext_cpp
+{
+
+rmw_ret_t
+get_subscription_minimum_separation(
+  const rmw_subscription_t * subscription,
+  rmw_time_t * minimum_separation)
+{
+  RMW_CHECK_ARGUMENT_FOR_NULL(subscription, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_ARGUMENT_FOR_NULL(minimum_separation, RMW_RET_INVALID_ARGUMENT);
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription handle,
+    subscription->implementation_identifier, rti_connext_identifier,
+    return RMW_RET_ERROR)
+
+  auto info = static_cast<ConnextStaticSubscriberInfo *>(subscription->data);
+  if (!info || !info->topic_reader_) {
+    RMW_SET_ERROR_MSG("subscription internal data reader is invalid");
+    return RMW_RET_ERROR;
+  }
+  DDS::DataReaderQos dds_qos;
+  if (info->topic_reader_->get_qos(dds_qos) != DDS::RETCODE_OK) {
+    RMW_SET_ERROR_MSG("subscription can't get data reader qos policies");
+    return RMW_RET_ERROR;
+  }
+  minimum_separation->sec = dds_qos.time_based_filter.minimum_separation.sec;
+  minimum_separation->nsec = dds_qos.time_based_filter.minimum_separation.nanosec;
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+set_subscription_filter_parameters(
+  const rmw_subscription_t * subscription,
+  const char * const * filter_parameters,
+  size_t filter_parameters_count)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription handle,
+    subscription->implementation_identifier, rti_connext_identifier,
+    return RMW_RET_ERROR)
+  if (filter_parameters_count > max_filter_parameters ||
+    (filter_parameters_count > 0 && !filter_parameters))
+  {
+    RMW_SET_ERROR_MSG("invalid filter parameters");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  auto subscriber_info = static_cast<ConnextStaticSubscriberInfo *>(subscription->data);
+  if (!subscriber_info) {
+    RMW_SET_ERROR_MSG("subscriber info handle is null");
+    return RMW_RET_ERROR;
+  }
+  if (!subscriber_info->content_filtered_topic_) {
+    RMW_SET_ERROR_MSG("subscription has no filter expression");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  DDS::StringSeq parameters;
+  if (!parameters.from_array(
+      const_cast<char **>(filter_parameters), static_cast<DDS::Long>(filter_parameters_count)))
+  {
+    RMW_SET_ERROR_MSG("failed to copy filter parameters");
+    return RMW_RET_ERROR;
+  }
+  DDS::ReturnCode_t status =
+    subscriber_info->content_filtered_topic_->set_expression_parameters(parameters);
+  if (status == DDS::RETCODE_BAD_PARAMETER) {
+    RMW_SET_ERROR_MSG("filter parameters don't fit the filter expression");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  if (status != DDS::RETCODE_OK) {
+    RMW_SET_ERROR_MSG("failed to set filter parameters");
+    return RMW_RET_ERROR;
+  }
+  return RMW_RET_OK;
+}
+
+}  // namespace rmw_connext_cpp
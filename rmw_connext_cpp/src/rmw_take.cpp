@@ -14,6 +14,10 @@
 
 #include <limits>
 
+#include "rcutils/allocator.h"
+#include "rcutils/types/uint8_array.h"
+
+#include "rmw/convert_rcutils_ret_to_rmw_ret.h"
 #include "rmw/error_handling.h"
 #include "rmw/impl/cpp/macros.hpp"
 #include "rmw/types.h"
@@ -22,43 +26,43 @@
 
 #include "rmw_connext_cpp/connext_static_subscriber_info.hpp"
 #include "rmw_connext_cpp/identifier.hpp"
+#include "rmw_connext_cpp/take.hpp"
+
+#include "subscription_push_queue.hpp"
+#include "take_helpers.hpp"
 
 // include patched generated code from the build folder
 #include "./connext_static_serialized_dataSupport.h"
 #include "./connext_static_serialized_data.h"
 
+bool
+is_local_publication(DDS::DataReader * data_reader, const DDS::SampleInfo & sample_info)
+{
+  // compare the lower 12 octets of the guids from the sender and this receiver
+  // if they are equal the sample has been sent from this process and should be ignored
+  const DDS::GUID_t & sender_guid = sample_info.original_publication_virtual_guid;
+  DDS::InstanceHandle_t receiver_instance_handle = data_reader->get_instance_handle();
+  for (size_t i = 0; i < 12; ++i) {
+    const DDS::Octet * sender_element = &(sender_guid.value[i]);
+    DDS::Octet * receiver_element =
+      &(reinterpret_cast<DDS::Octet *>(&receiver_instance_handle)[i]);
+    if (*sender_element != *receiver_element) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Take the next sample, which stays loaned from the reader if it is taken.
+// The caller has to return the loan of a taken sample with return_loan().
 static bool
 take(
-  DDS::DataReader * dds_data_reader,
+  ConnextStaticSerializedDataDataReader * data_reader,
   bool ignore_local_publications,
-  rcutils_uint8_array_t * cdr_stream,
-  bool * taken,
-  void * sending_publication_handle,
-  rmw_subscription_allocation_t * allocation)
+  ConnextStaticSerializedDataSeq & dds_messages,
+  DDS::SampleInfoSeq & sample_infos,
+  bool * taken)
 {
-  (void) allocation;
-  if (!dds_data_reader) {
-    RMW_SET_ERROR_MSG("dds_data_reader is null");
-    return false;
-  }
-  if (!cdr_stream) {
-    RMW_SET_ERROR_MSG("cdr stream handle is null");
-    return false;
-  }
-  if (!taken) {
-    RMW_SET_ERROR_MSG("taken handle is null");
-    return false;
-  }
-
-  ConnextStaticSerializedDataDataReader * data_reader =
-    ConnextStaticSerializedDataDataReader::narrow(dds_data_reader);
-  if (!data_reader) {
-    RMW_SET_ERROR_MSG("failed to narrow data reader");
-    return false;
-  }
-
-  ConnextStaticSerializedDataSeq dds_messages;
-  DDS::SampleInfoSeq sample_infos;
   bool ignore_sample = false;
 
   DDS::ReturnCode_t status = data_reader->take(
@@ -84,48 +88,185 @@ take(
     // skip sample without data
     ignore_sample = true;
   } else if (ignore_local_publications) {
-    // compare the lower 12 octets of the guids from the sender and this receiver
-    // if they are equal the sample has been sent from this process and should be ignored
-    DDS::GUID_t sender_guid = sample_info.original_publication_virtual_guid;
-    DDS::InstanceHandle_t receiver_instance_handle = dds_data_reader->get_instance_handle();
-    ignore_sample = true;
-    for (size_t i = 0; i < 12; ++i) {
-      DDS::Octet * sender_element = &(sender_guid.value[i]);
-      DDS::Octet * receiver_element =
-        &(reinterpret_cast<DDS::Octet *>(&receiver_instance_handle)[i]);
-      if (*sender_element != *receiver_element) {
-        ignore_sample = false;
-        break;
-      }
-    }
+    ignore_sample = is_local_publication(data_reader, sample_info);
+  }
+
+  if (!ignore_sample &&
+    static_cast<size_t>(dds_messages[0].serialized_data.length()) >
+    (std::numeric_limits<unsigned int>::max)())
+  {
+    RMW_SET_ERROR_MSG("cdr_stream->buffer_length unexpectedly larger than max unsiged int value");
+    data_reader->return_loan(dds_messages, sample_infos);
+    *taken = false;
+    return false;
+  }
+
+  if (ignore_sample) {
+    data_reader->return_loan(dds_messages, sample_infos);
   }
-  if (sample_info.valid_data && sending_publication_handle) {
-    *static_cast<DDS::InstanceHandle_t *>(sending_publication_handle) =
-      sample_info.publication_handle;
+  *taken = !ignore_sample;
+  return true;
+}
+
+// Return a non-owning view onto the serialized data of a loaned sample.
+static rcutils_uint8_array_t
+get_cdr_stream_view(const ConnextStaticSerializedData & dds_message)
+{
+  rcutils_uint8_array_t cdr_stream = rcutils_get_zero_initialized_uint8_array();
+  const DDS::Long length = dds_message.serialized_data.length();
+  if (length > 0) {
+    cdr_stream.buffer = reinterpret_cast<uint8_t *>(
+      const_cast<DDS::Octet *>(&dds_message.serialized_data[0]));
+    cdr_stream.buffer_length = static_cast<size_t>(length);
+    cdr_stream.buffer_capacity = static_cast<size_t>(length);
   }
+  return cdr_stream;
+}
 
-  if (!ignore_sample) {
-    cdr_stream->buffer_length = dds_messages[0].serialized_data.length();
-    // TODO(karsten1987): This malloc has to go!
-    cdr_stream->buffer =
-      reinterpret_cast<uint8_t *>(malloc(cdr_stream->buffer_length * sizeof(uint8_t)));
+// Fill the message info of a taken sample.
+static void
+fill_message_info(const DDS::SampleInfo & sample_info, rmw_message_info_t * message_info)
+{
+  rmw_gid_t * sender_gid = &message_info->publisher_gid;
+  sender_gid->implementation_identifier = rti_connext_identifier;
+  memset(sender_gid->data, 0, RMW_GID_STORAGE_SIZE);
+  auto detail = reinterpret_cast<ConnextPublisherGID *>(sender_gid->data);
+  detail->publication_handle = sample_info.publication_handle;
+  message_info->from_intra_process = false;
+}
 
-    if (cdr_stream->buffer_length > (std::numeric_limits<unsigned int>::max)()) {
-      RMW_SET_ERROR_MSG("cdr_stream->buffer_length unexpectedly larger than max unsiged int value");
-      data_reader->return_loan(dds_messages, sample_infos);
-      *taken = false;
-      return false;
+static int64_t
+dds_time_to_nanoseconds(const DDS::Time_t & time)
+{
+  return static_cast<int64_t>(time.sec) * 1000000000LL + static_cast<int64_t>(time.nanosec);
+}
+
+// Fill the message info of a taken sample including the metadata kept by DDS.
+static void
+fill_extended_message_info(
+  const DDS::SampleInfo & sample_info,
+  rmw_connext_cpp::ExtendedMessageInfo * message_info)
+{
+  fill_message_info(sample_info, &message_info->message_info);
+  message_info->source_timestamp = dds_time_to_nanoseconds(sample_info.source_timestamp);
+  message_info->received_timestamp = dds_time_to_nanoseconds(sample_info.reception_timestamp);
+  const DDS::SequenceNumber_t & sequence_number = sample_info.publication_sequence_number;
+  message_info->publication_sequence_number =
+    (static_cast<uint64_t>(sequence_number.high) << 32) |
+    static_cast<uint64_t>(sequence_number.low);
+}
+
+// Copy serialized data into a serialized message, growing its buffer if needed.
+static rmw_ret_t
+copy_cdr_stream(
+  const rcutils_uint8_array_t & cdr_stream,
+  rmw_serialized_message_t * serialized_message)
+{
+  if (serialized_message->buffer_capacity < cdr_stream.buffer_length) {
+    // grow the buffer with the message's own allocator, only a message that has never
+    // been initialized falls back to the default allocator
+    if (!serialized_message->buffer &&
+      !rcutils_allocator_is_valid(&serialized_message->allocator))
+    {
+      serialized_message->allocator = rcutils_get_default_allocator();
+      serialized_message->buffer_capacity = 0;
+    }
+    rcutils_ret_t rcutils_ret =
+      rcutils_uint8_array_resize(serialized_message, cdr_stream.buffer_length);
+    if (rcutils_ret != RCUTILS_RET_OK) {
+      return rmw_convert_rcutils_ret_to_rmw_ret(rcutils_ret);
     }
-    memcpy(cdr_stream->buffer, &dds_messages[0].serialized_data[0], cdr_stream->buffer_length);
+  }
+  if (cdr_stream.buffer_length > 0) {
+    memcpy(serialized_message->buffer, cdr_stream.buffer, cdr_stream.buffer_length);
+  }
+  serialized_message->buffer_length = cdr_stream.buffer_length;
+  return RMW_RET_OK;
+}
 
-    *taken = true;
-  } else {
+// Take the oldest sample queued by the listener of a subscription in push mode.
+static rmw_ret_t
+take_from_push_queue(
+  SubscriptionPushQueue * push_queue,
+  const message_type_support_callbacks_t * callbacks,
+  void * ros_message,
+  bool * taken,
+  rmw_connext_cpp::ExtendedMessageInfo * message_info)
+{
+  size_t index = 0;
+  *taken = push_queue->pop(index);
+  if (!*taken) {
+    return RMW_RET_OK;
+  }
+  auto ret = RMW_RET_OK;
+  rcutils_uint8_array_t cdr_stream = push_queue->data(index);
+  if (!cdr_stream.buffer || !callbacks->to_message(&cdr_stream, ros_message)) {
+    RMW_SET_ERROR_MSG("can't convert cdr stream to ros message");
+    ret = RMW_RET_ERROR;
+  }
+  if (message_info) {
+    fill_extended_message_info(push_queue->sample_info(index), message_info);
+  }
+  push_queue->release(index);
+  return ret;
+}
+
+// Take the oldest sample queued by the listener of a subscription in push mode as is.
+static rmw_ret_t
+take_serialized_from_push_queue(
+  SubscriptionPushQueue * push_queue,
+  rmw_serialized_message_t * serialized_message,
+  bool * taken,
+  rmw_connext_cpp::ExtendedMessageInfo * message_info)
+{
+  size_t index = 0;
+  *taken = push_queue->pop(index);
+  if (!*taken) {
+    return RMW_RET_OK;
+  }
+  auto ret = copy_cdr_stream(push_queue->data(index), serialized_message);
+  if (ret != RMW_RET_OK) {
+    // the sample is lost, as it would be when the queue overflows
     *taken = false;
+  } else if (message_info) {
+    fill_extended_message_info(push_queue->sample_info(index), message_info);
   }
+  push_queue->release(index);
+  return ret;
+}
 
-  data_reader->return_loan(dds_messages, sample_infos);
+// Return the sequences of the allocation to loan the samples into, or null on error.
+static ConnextStaticSubscriptionAllocation *
+get_allocation_info(
+  rmw_subscription_allocation_t * allocation,
+  const message_type_support_callbacks_t * callbacks)
+{
+  if (allocation->implementation_identifier != rti_connext_identifier) {
+    RMW_SET_ERROR_MSG("subscription allocation is not from this rmw implementation");
+    return nullptr;
+  }
+  auto allocation_info = static_cast<ConnextStaticSubscriptionAllocation *>(allocation->data);
+  if (!allocation_info || !allocation_info->dds_messages_ || !allocation_info->sample_infos_) {
+    RMW_SET_ERROR_MSG("subscription allocation info handle is null");
+    return nullptr;
+  }
+  if (allocation_info->callbacks_ != callbacks) {
+    RMW_SET_ERROR_MSG("subscription allocation was initialized for a different message type");
+    return nullptr;
+  }
+  return allocation_info;
+}
 
-  return status == DDS::RETCODE_OK;
+// Narrow the reader of a subscription, setting the error message on failure.
+static ConnextStaticSerializedDataDataReader *
+narrow_data_reader(DDS::DataReader * dds_data_reader)
+{
+  ConnextStaticSerializedDataDataReader * data_reader =
+    ConnextStaticSerializedDataDataReader::narrow(dds_data_reader);
+  if (!data_reader) {
+    RMW_SET_ERROR_MSG("failed to narrow data reader");
+  }
+  return data_reader;
 }
 
 extern "C"
@@ -135,7 +276,7 @@ _take(
   const rmw_subscription_t * subscription,
   void * ros_message,
   bool * taken,
-  DDS::InstanceHandle_t * sending_publication_handle,
+  rmw_connext_cpp::ExtendedMessageInfo * message_info,
   rmw_subscription_allocation_t * allocation)
 {
   if (!subscription) {
@@ -172,27 +313,54 @@ _take(
     RMW_SET_ERROR_MSG("callbacks handle is null");
     return RMW_RET_ERROR;
   }
+  if (subscriber_info->push_queue_) {
+    return take_from_push_queue(
+      subscriber_info->push_queue_, callbacks, ros_message, taken, message_info);
+  }
+  ConnextStaticSubscriptionAllocation * allocation_info = nullptr;
+  if (allocation) {
+    allocation_info = get_allocation_info(allocation, callbacks);
+    if (!allocation_info) {
+      return RMW_RET_ERROR;
+    }
+  }
 
-  // fetch the incoming message as cdr stream
-  rcutils_uint8_array_t cdr_stream = rcutils_get_zero_initialized_uint8_array();
+  ConnextStaticSerializedDataDataReader * data_reader = narrow_data_reader(topic_reader);
+  if (!data_reader) {
+    return RMW_RET_ERROR;
+  }
+
+  // fetch the incoming message, it stays loaned while being converted
+  ConnextStaticSerializedDataSeq local_dds_messages;
+  DDS::SampleInfoSeq local_sample_infos;
+  ConnextStaticSerializedDataSeq & dds_messages = allocation_info ?
+    *allocation_info->dds_messages_ : local_dds_messages;
+  DDS::SampleInfoSeq & sample_infos = allocation_info ?
+    *allocation_info->sample_infos_ : local_sample_infos;
   if (!take(
-      topic_reader, subscription->options.ignore_local_publications, &cdr_stream, taken,
-      sending_publication_handle, allocation))
+      data_reader, subscription->options.ignore_local_publications, dds_messages, sample_infos,
+      taken))
   {
     RMW_SET_ERROR_MSG("error occured while taking message");
     return RMW_RET_ERROR;
   }
-  // convert the cdr stream to the message
-  if (*taken && !callbacks->to_message(&cdr_stream, ros_message)) {
-    RMW_SET_ERROR_MSG("can't convert cdr stream to ros message");
-    return RMW_RET_ERROR;
+  if (!*taken) {
+    return RMW_RET_OK;
   }
 
-  // the call to take allocates memory for the serialized message
-  // we have to free this here again
-  free(cdr_stream.buffer);
+  // convert the cdr stream to the message straight from the loaned sample
+  auto ret = RMW_RET_OK;
+  rcutils_uint8_array_t cdr_stream = get_cdr_stream_view(dds_messages[0]);
+  if (!cdr_stream.buffer || !callbacks->to_message(&cdr_stream, ros_message)) {
+    RMW_SET_ERROR_MSG("can't convert cdr stream to ros message");
+    ret = RMW_RET_ERROR;
+  }
+  if (message_info) {
+    fill_extended_message_info(sample_infos[0], message_info);
+  }
+  data_reader->return_loan(dds_messages, sample_infos);
 
-  return RMW_RET_OK;
+  return ret;
 }
 
 rmw_ret_t
@@ -217,18 +385,15 @@ rmw_take_with_info(
     RMW_SET_ERROR_MSG("message info is null");
     return RMW_RET_ERROR;
   }
-  DDS::InstanceHandle_t sending_publication_handle;
-  auto ret = _take(subscription, ros_message, taken, &sending_publication_handle, allocation);
+  rmw_connext_cpp::ExtendedMessageInfo extended_info;
+  auto ret = _take(subscription, ros_message, taken, &extended_info, allocation);
   if (ret != RMW_RET_OK) {
     // Error string is already set.
     return RMW_RET_ERROR;
   }
-
-  rmw_gid_t * sender_gid = &message_info->publisher_gid;
-  sender_gid->implementation_identifier = rti_connext_identifier;
-  memset(sender_gid->data, 0, RMW_GID_STORAGE_SIZE);
-  auto detail = reinterpret_cast<ConnextPublisherGID *>(sender_gid->data);
-  detail->publication_handle = sending_publication_handle;
+  if (*taken) {
+    *message_info = extended_info.message_info;
+  }
 
   return RMW_RET_OK;
 }
@@ -238,7 +403,7 @@ _take_serialized_message(
   const rmw_subscription_t * subscription,
   rmw_serialized_message_t * serialized_message,
   bool * taken,
-  DDS::InstanceHandle_t * sending_publication_handle,
+  rmw_connext_cpp::ExtendedMessageInfo * message_info,
   rmw_subscription_allocation_t * allocation)
 {
   if (!subscription) {
@@ -275,15 +440,52 @@ _take_serialized_message(
     RMW_SET_ERROR_MSG("callbacks handle is null");
     return RMW_RET_ERROR;
   }
+  if (subscriber_info->push_queue_) {
+    return take_serialized_from_push_queue(
+      subscriber_info->push_queue_, serialized_message, taken, message_info);
+  }
+  ConnextStaticSubscriptionAllocation * allocation_info = nullptr;
+  if (allocation) {
+    allocation_info = get_allocation_info(allocation, callbacks);
+    if (!allocation_info) {
+      return RMW_RET_ERROR;
+    }
+  }
+
+  ConnextStaticSerializedDataDataReader * data_reader = narrow_data_reader(topic_reader);
+  if (!data_reader) {
+    return RMW_RET_ERROR;
+  }
 
   // fetch the incoming message as cdr stream
+  ConnextStaticSerializedDataSeq local_dds_messages;
+  DDS::SampleInfoSeq local_sample_infos;
+  ConnextStaticSerializedDataSeq & dds_messages = allocation_info ?
+    *allocation_info->dds_messages_ : local_dds_messages;
+  DDS::SampleInfoSeq & sample_infos = allocation_info ?
+    *allocation_info->sample_infos_ : local_sample_infos;
   if (!take(
-      topic_reader, subscription->options.ignore_local_publications, serialized_message, taken,
-      sending_publication_handle, allocation))
+      data_reader, subscription->options.ignore_local_publications, dds_messages, sample_infos,
+      taken))
   {
     RMW_SET_ERROR_MSG("error occured while taking message");
     return RMW_RET_ERROR;
   }
+  if (!*taken) {
+    return RMW_RET_OK;
+  }
+
+  // the serialized message outlives the loan, so the data has to be copied
+  auto ret = copy_cdr_stream(get_cdr_stream_view(dds_messages[0]), serialized_message);
+  if (ret != RMW_RET_OK) {
+    data_reader->return_loan(dds_messages, sample_infos);
+    *taken = false;
+    return ret;
+  }
+  if (message_info) {
+    fill_extended_message_info(sample_infos[0], message_info);
+  }
+  data_reader->return_loan(dds_messages, sample_infos);
 
   return RMW_RET_OK;
 }
@@ -310,20 +512,16 @@ rmw_take_serialized_message_with_info(
     RMW_SET_ERROR_MSG("message info is null");
     return RMW_RET_ERROR;
   }
-  DDS::InstanceHandle_t sending_publication_handle;
+  rmw_connext_cpp::ExtendedMessageInfo extended_info;
   auto ret = _take_serialized_message(
-    subscription, serialized_message, taken,
-    &sending_publication_handle, allocation);
+    subscription, serialized_message, taken, &extended_info, allocation);
   if (ret != RMW_RET_OK) {
     // Error string is already set.
     return RMW_RET_ERROR;
   }
-
-  rmw_gid_t * sender_gid = &message_info->publisher_gid;
-  sender_gid->implementation_identifier = rti_connext_identifier;
-  memset(sender_gid->data, 0, RMW_GID_STORAGE_SIZE);
-  auto detail = reinterpret_cast<ConnextPublisherGID *>(sender_gid->data);
-  detail->publication_handle = sending_publication_handle;
+  if (*taken) {
+    *message_info = extended_info.message_info;
+  }
 
   return RMW_RET_OK;
 }
@@ -375,3 +573,287 @@ rmw_return_loaned_message_from_subscription(
   return RMW_RET_UNSUPPORTED;
 }
 }  // extern "C"
+
+namespace rmw_connext_cpp
+{
+
+rmw_ret_t
+take_sequence(
+  const rmw_subscription_t * subscription,
+  size_t count,
+  void * const * ros_messages,
+  rmw_message_info_t * message_infos,
+  size_t * taken,
+  rmw_subscription_allocation_t * allocation)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription handle,
+    subscription->implementation_identifier, rti_connext_identifier,
+    return RMW_RET_ERROR)
+  if (count == 0 || !ros_messages) {
+    RMW_SET_ERROR_MSG("no ros messages to take into");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  if (!taken) {
+    RMW_SET_ERROR_MSG("taken handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  *taken = 0;
+
+  ConnextStaticSubscriberInfo * subscriber_info =
+    static_cast<ConnextStaticSubscriberInfo *>(subscription->data);
+  if (!subscriber_info) {
+    RMW_SET_ERROR_MSG("subscriber info handle is null");
+    return RMW_RET_ERROR;
+  }
+  const message_type_support_callbacks_t * callbacks = subscriber_info->callbacks_;
+  if (!callbacks) {
+    RMW_SET_ERROR_MSG("callbacks handle is null");
+    return RMW_RET_ERROR;
+  }
+  if (subscriber_info->push_queue_) {
+    rmw_connext_cpp::ExtendedMessageInfo extended_info;
+    while (*taken < count) {
+      bool message_taken = false;
+      auto ret = take_from_push_queue(
+        subscriber_info->push_queue_, callbacks, ros_messages[*taken], &message_taken,
+        message_infos ? &extended_info : nullptr);
+      if (ret != RMW_RET_OK) {
+        return ret;
+      }
+      if (!message_taken) {
+        break;
+      }
+      if (message_infos) {
+        message_infos[*taken] = extended_info.message_info;
+      }
+      ++*taken;
+    }
+    return RMW_RET_OK;
+  }
+  ConnextStaticSubscriptionAllocation * allocation_info = nullptr;
+  if (allocation) {
+    allocation_info = get_allocation_info(allocation, callbacks);
+    if (!allocation_info) {
+      return RMW_RET_ERROR;
+    }
+  }
+  ConnextStaticSerializedDataDataReader * data_reader =
+    narrow_data_reader(subscriber_info->topic_reader_);
+  if (!data_reader) {
+    return RMW_RET_ERROR;
+  }
+
+  ConnextStaticSerializedDataSeq local_dds_messages;
+  DDS::SampleInfoSeq local_sample_infos;
+  ConnextStaticSerializedDataSeq & dds_messages = allocation_info ?
+    *allocation_info->dds_messages_ : local_dds_messages;
+  DDS::SampleInfoSeq & sample_infos = allocation_info ?
+    *allocation_info->sample_infos_ : local_sample_infos;
+
+  // Samples without data or ignored as local publication take up space in the loan
+  // without producing a message, so fewer than count messages may be returned.
+  const size_t max_length = static_cast<size_t>((std::numeric_limits<DDS::Long>::max)());
+  const DDS::Long max_samples = static_cast<DDS::Long>(count < max_length ? count : max_length);
+  DDS::ReturnCode_t status = data_reader->take(
+    dds_messages,
+    sample_infos,
+    max_samples,
+    DDS::ANY_SAMPLE_STATE,
+    DDS::ANY_VIEW_STATE,
+    DDS::ANY_INSTANCE_STATE);
+  if (status == DDS::RETCODE_NO_DATA) {
+    data_reader->return_loan(dds_messages, sample_infos);
+    return RMW_RET_OK;
+  }
+  if (status != DDS::RETCODE_OK) {
+    RMW_SET_ERROR_MSG("take failed");
+    data_reader->return_loan(dds_messages, sample_infos);
+    return RMW_RET_ERROR;
+  }
+
+  auto ret = RMW_RET_OK;
+  const bool ignore_local_publications = subscription->options.ignore_local_publications;
+  for (DDS::Long i = 0; i < dds_messages.length(); ++i) {
+    const DDS::SampleInfo & sample_info = sample_infos[i];
+    if (
+      !sample_info.valid_data ||
+      (ignore_local_publications && is_local_publication(data_reader, sample_info)))
+    {
+      continue;
+    }
+    rcutils_uint8_array_t cdr_stream = get_cdr_stream_view(dds_messages[i]);
+    if (!cdr_stream.buffer || !callbacks->to_message(&cdr_stream, ros_messages[*taken])) {
+      RMW_SET_ERROR_MSG("can't convert cdr stream to ros message");
+      ret = RMW_RET_ERROR;
+      break;
+    }
+    if (message_infos) {
+      fill_message_info(sample_info, &message_infos[*taken]);
+    }
+    ++*taken;
+  }
+  data_reader->return_loan(dds_messages, sample_infos);
+
+  return ret;
+}
+
+rmw_ret_t
+take_with_extended_info(
+  const rmw_subscription_t * subscription,
+  void * ros_message,
+  bool * taken,
+  ExtendedMessageInfo * message_info,
+  rmw_subscription_allocation_t * allocation)
+{
+  if (!message_info) {
+    RMW_SET_ERROR_MSG("message info is null");
+    return RMW_RET_ERROR;
+  }
+  return _take(subscription, ros_message, taken, message_info, allocation);
+}
+
+rmw_ret_t
+take_serialized_message_with_extended_info(
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message,
+  bool * taken,
+  ExtendedMessageInfo * message_info,
+  rmw_subscription_allocation_t * allocation)
+{
+  if (!message_info) {
+    RMW_SET_ERROR_MSG("message info is null");
+    return RMW_RET_ERROR;
+  }
+  return _take_serialized_message(
+    subscription, serialized_message, taken, message_info, allocation);
+}
+
+rmw_ret_t
+take_serialized_message_loan(
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message,
+  bool * taken,
+  rmw_message_info_t * message_info)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription handle,
+    subscription->implementation_identifier, rti_connext_identifier,
+    return RMW_RET_ERROR)
+  if (!serialized_message) {
+    RMW_SET_ERROR_MSG("serialized message handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  if (!taken) {
+    RMW_SET_ERROR_MSG("taken handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  ConnextStaticSubscriberInfo * subscriber_info =
+    static_cast<ConnextStaticSubscriberInfo *>(subscription->data);
+  if (!subscriber_info) {
+    RMW_SET_ERROR_MSG("subscriber info handle is null");
+    return RMW_RET_ERROR;
+  }
+  if (subscriber_info->push_queue_) {
+    RMW_SET_ERROR_MSG("serialized loans are not available for subscriptions with a push queue");
+    return RMW_RET_UNSUPPORTED;
+  }
+  ConnextStaticSerializedDataDataReader * data_reader =
+    narrow_data_reader(subscriber_info->topic_reader_);
+  if (!data_reader) {
+    return RMW_RET_ERROR;
+  }
+
+  ConnextStaticSerializedLoan * loan = subscriber_info->acquire_serialized_loan();
+  if (!loan) {
+    return RMW_RET_BAD_ALLOC;
+  }
+  if (!take(
+      data_reader, subscription->options.ignore_local_publications,
+      *loan->dds_messages_, *loan->sample_infos_, taken))
+  {
+    subscriber_info->release_serialized_loan(loan);
+    RMW_SET_ERROR_MSG("error occured while taking message");
+    return RMW_RET_ERROR;
+  }
+  if (!*taken) {
+    subscriber_info->release_serialized_loan(loan);
+    return RMW_RET_OK;
+  }
+
+  rcutils_uint8_array_t cdr_stream = get_cdr_stream_view((*loan->dds_messages_)[0]);
+  if (!cdr_stream.buffer) {
+    data_reader->return_loan(*loan->dds_messages_, *loan->sample_infos_);
+    subscriber_info->release_serialized_loan(loan);
+    *taken = false;
+    RMW_SET_ERROR_MSG("no serialized data in taken sample");
+    return RMW_RET_ERROR;
+  }
+  subscriber_info->add_serialized_loan(cdr_stream.buffer, loan);
+
+  // the buffer belongs to the reader, the zero allocator keeps it from being freed
+  *serialized_message = cdr_stream;
+  serialized_message->allocator = rcutils_get_zero_initialized_allocator();
+
+  if (message_info) {
+    fill_message_info((*loan->sample_infos_)[0], message_info);
+  }
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+return_serialized_message_loan(
+  const rmw_subscription_t * subscription,
+  rmw_serialized_message_t * serialized_message)
+{
+  if (!subscription) {
+    RMW_SET_ERROR_MSG("subscription handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    subscription handle,
+    subscription->implementation_identifier, rti_connext_identifier,
+    return RMW_RET_ERROR)
+  if (!serialized_message) {
+    RMW_SET_ERROR_MSG("serialized message handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+
+  ConnextStaticSubscriberInfo * subscriber_info =
+    static_cast<ConnextStaticSubscriberInfo *>(subscription->data);
+  if (!subscriber_info) {
+    RMW_SET_ERROR_MSG("subscriber info handle is null");
+    return RMW_RET_ERROR;
+  }
+  ConnextStaticSerializedDataDataReader * data_reader =
+    narrow_data_reader(subscriber_info->topic_reader_);
+  if (!data_reader) {
+    return RMW_RET_ERROR;
+  }
+
+  ConnextStaticSerializedLoan * loan =
+    subscriber_info->remove_serialized_loan(serialized_message->buffer);
+  if (!loan) {
+    RMW_SET_ERROR_MSG("serialized message is not loaned from this subscription");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  DDS::ReturnCode_t status = data_reader->return_loan(*loan->dds_messages_, *loan->sample_infos_);
+  subscriber_info->release_serialized_loan(loan);
+  *serialized_message = rcutils_get_zero_initialized_uint8_array();
+  if (status != DDS::RETCODE_OK) {
+    RMW_SET_ERROR_MSG("failed to return loaned sample");
+    return RMW_RET_ERROR;
+  }
+  return RMW_RET_OK;
+}
+
+}  // namespace rmw_connext_cpp
@@ -17,6 +17,7 @@
 #include "rmw_connext_shared_cpp/wait_set.hpp"
 
 #include "rmw_connext_cpp/identifier.hpp"
+#include "rmw_connext_cpp/wait_set_options.hpp"
 
 extern "C"
 {
@@ -32,3 +33,15 @@ rmw_destroy_wait_set(rmw_wait_set_t * wait_set)
   return destroy_wait_set(rti_connext_identifier, wait_set);
 }
 }  // extern "C"
+
+namespace rmw_connext_cpp
+{
+
+rmw_ret_t
+set_wait_set_backend(rmw_wait_set_t * wait_set, WaitSetBackend backend)
+{
+  return set_wait_set_epoll_backend(
+    rti_connext_identifier, wait_set, backend == WaitSetBackend::epoll);
+}
+
+}  // namespace rmw_connext_cpp
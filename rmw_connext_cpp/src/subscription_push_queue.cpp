@@ -0,0 +1,210 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstring>
+
+#include "rcutils/allocator.h"
+#include "rcutils/logging_macros.h"
+
+#include "rmw/error_handling.h"
+
+#include "subscription_push_queue.hpp"
+#include "take_helpers.hpp"
+
+// include patched generated code from the build folder
+#include "connext_static_serialized_dataSupport.h"
+
+SubscriptionPushQueue::SubscriptionPushQueue(
+  size_t depth,
+  size_t slot_capacity,
+  bool ignore_local_publications,
+  ConnextWaitNotifier * wait_notifier)
+: slot_count_(depth),
+  slot_capacity_(slot_capacity),
+  ignore_local_publications_(ignore_local_publications),
+  free_slots_(depth),
+  ready_slots_(depth),
+  ready_count_(0),
+  dropped_(0),
+  wait_notifier_(wait_notifier)
+{}
+
+SubscriptionPushQueue::~SubscriptionPushQueue()
+{
+  for (auto & slot : slots_) {
+    if (slot.data.buffer) {
+      slot.data.allocator.deallocate(slot.data.buffer, slot.data.allocator.state);
+    }
+  }
+}
+
+bool
+SubscriptionPushQueue::init()
+{
+  Slot empty_slot;
+  empty_slot.data = rcutils_get_zero_initialized_uint8_array();
+  memset(&empty_slot.sample_info, 0, sizeof(empty_slot.sample_info));
+  slots_.resize(slot_count_, empty_slot);
+  for (size_t i = 0; i < slot_count_; ++i) {
+    rcutils_uint8_array_t & data = slots_[i].data;
+    data.allocator = rcutils_get_default_allocator();
+    if (slot_capacity_ > 0) {
+      data.buffer = static_cast<uint8_t *>(
+        data.allocator.allocate(slot_capacity_, data.allocator.state));
+      if (!data.buffer) {
+        RMW_SET_ERROR_MSG("failed to allocate memory for the subscription push queue");
+        return false;
+      }
+      data.buffer_capacity = slot_capacity_;
+    }
+    free_slots_.push(i);
+  }
+  return true;
+}
+
+DDS::GuardCondition *
+SubscriptionPushQueue::get_condition()
+{
+  return &condition_;
+}
+
+bool
+SubscriptionPushQueue::pop(size_t & index)
+{
+  if (!ready_slots_.pop(index)) {
+    return false;
+  }
+  if (--ready_count_ == 0) {
+    condition_.set_trigger_value(DDS::BOOLEAN_FALSE);
+    // a sample may have been queued since, which didn't trigger the condition again
+    if (ready_count_ > 0) {
+      condition_.set_trigger_value(DDS::BOOLEAN_TRUE);
+    }
+  }
+  return true;
+}
+
+const rcutils_uint8_array_t &
+SubscriptionPushQueue::data(size_t index) const
+{
+  return slots_[index].data;
+}
+
+const DDS::SampleInfo &
+SubscriptionPushQueue::sample_info(size_t index) const
+{
+  return slots_[index].sample_info;
+}
+
+void
+SubscriptionPushQueue::release(size_t index)
+{
+  // Never fails, each queue can hold all slots.
+  free_slots_.push(index);
+}
+
+uint64_t
+SubscriptionPushQueue::dropped() const
+{
+  return dropped_;
+}
+
+void
+SubscriptionPushQueue::on_data_available(DDS::DataReader * reader)
+{
+  ConnextStaticSerializedDataDataReader * data_reader =
+    ConnextStaticSerializedDataDataReader::narrow(reader);
+  if (!data_reader) {
+    RCUTILS_LOG_ERROR_NAMED("rmw_connext_cpp", "failed to narrow data reader");
+    return;
+  }
+
+  ConnextStaticSerializedDataSeq dds_messages;
+  DDS::SampleInfoSeq sample_infos;
+  while (true) {
+    DDS::ReturnCode_t status = data_reader->take(
+      dds_messages,
+      sample_infos,
+      DDS::LENGTH_UNLIMITED,
+      DDS::ANY_SAMPLE_STATE,
+      DDS::ANY_VIEW_STATE,
+      DDS::ANY_INSTANCE_STATE);
+    if (status != DDS::RETCODE_OK) {
+      if (status != DDS::RETCODE_NO_DATA) {
+        RCUTILS_LOG_ERROR_NAMED("rmw_connext_cpp", "failed to take samples into push queue");
+      }
+      data_reader->return_loan(dds_messages, sample_infos);
+      break;
+    }
+    for (DDS::Long i = 0; i < dds_messages.length(); ++i) {
+      const DDS::SampleInfo & sample_info = sample_infos[i];
+      if (
+        !sample_info.valid_data ||
+        (ignore_local_publications_ && is_local_publication(data_reader, sample_info)))
+      {
+        continue;
+      }
+      push(dds_messages[i].serialized_data, sample_info);
+    }
+    data_reader->return_loan(dds_messages, sample_infos);
+  }
+  if (wait_notifier_ && ready_count_ > 0) {
+    wait_notifier_->notify();
+  }
+}
+
+void
+SubscriptionPushQueue::push(
+  const DDS::OctetSeq & serialized_data,
+  const DDS::SampleInfo & sample_info)
+{
+  size_t index = 0;
+  if (!free_slots_.pop(index)) {
+    // Replace the oldest queued sample, unless takers hold every slot.
+    if (!ready_slots_.pop(index)) {
+      ++dropped_;
+      return;
+    }
+    --ready_count_;
+    ++dropped_;
+  }
+
+  Slot & slot = slots_[index];
+  const size_t length = static_cast<size_t>(serialized_data.length());
+  if (slot.data.buffer_capacity < length) {
+    void * buffer = slot.data.allocator.reallocate(
+      slot.data.buffer, length, slot.data.allocator.state);
+    if (!buffer) {
+      release(index);
+      ++dropped_;
+      RCUTILS_LOG_ERROR_NAMED(
+        "rmw_connext_cpp", "failed to allocate memory for sample in push queue");
+      return;
+    }
+    slot.data.buffer = static_cast<uint8_t *>(buffer);
+    slot.data.buffer_capacity = length;
+  }
+  if (length > 0) {
+    memcpy(slot.data.buffer, &serialized_data[0], length);
+  }
+  slot.data.buffer_length = length;
+  slot.sample_info = sample_info;
+
+  // Counted before pushing so that the count never falls below the number of queued slots.
+  if (ready_count_++ == 0) {
+    condition_.set_trigger_value(DDS::BOOLEAN_TRUE);
+  }
+  // Never fails, each queue can hold all slots.
+  ready_slots_.push(index);
+}
@@ -0,0 +1,112 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef SUBSCRIPTION_PUSH_QUEUE_HPP_
+#define SUBSCRIPTION_PUSH_QUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "rcutils/types/uint8_array.h"
+
+#include "rmw_connext_shared_cpp/ndds_include.hpp"
+#include "rmw_connext_shared_cpp/wait_notifier.hpp"
+
+#include "bounded_index_queue.hpp"
+
+/// Receives the samples of one data reader into preallocated slots as they arrive.
+/**
+ * The listener drains the reader on the DDS receive thread, copying every sample
+ * into a free slot which is then handed to takers through a lock-free queue.
+ * When all slots are queued, the oldest queued sample is replaced.
+ * A guard condition is triggered as long as samples are queued, so waiting for the
+ * subscription doesn't involve the read condition and taking doesn't call into DDS.
+ */
+class SubscriptionPushQueue : public DDS::DataReaderListener
+{
+public:
+  /// Construct the queue, notifying the given notifier whenever samples are queued.
+  SubscriptionPushQueue(
+    size_t depth,
+    size_t slot_capacity,
+    bool ignore_local_publications,
+    ConnextWaitNotifier * wait_notifier);
+
+  ~SubscriptionPushQueue();
+
+  /// Allocate the slots.
+  /**
+   * \return false if the resources could not be allocated, with the error message set
+   */
+  bool
+  init();
+
+  /// Condition triggered while samples are queued.
+  DDS::GuardCondition *
+  get_condition();
+
+  /// Remove the oldest queued sample.
+  /**
+   * The slot has to be given back with release() once its data has been used.
+   * \return false if no sample is queued
+   */
+  bool
+  pop(size_t & index);
+
+  /// Serialized data of a popped sample.
+  const rcutils_uint8_array_t &
+  data(size_t index) const;
+
+  /// Sample info of a popped sample.
+  const DDS::SampleInfo &
+  sample_info(size_t index) const;
+
+  /// Give a popped slot back to be filled again.
+  void
+  release(size_t index);
+
+  /// Number of samples replaced or dropped because no slot was free.
+  uint64_t
+  dropped() const;
+
+  void
+  on_data_available(DDS::DataReader * reader) override;
+
+private:
+  // Copy a sample into a free slot and queue it.
+  void
+  push(const DDS::OctetSeq & serialized_data, const DDS::SampleInfo & sample_info);
+
+  struct Slot
+  {
+    rcutils_uint8_array_t data;
+    DDS::SampleInfo sample_info;
+  };
+
+  const size_t slot_count_;
+  const size_t slot_capacity_;
+  const bool ignore_local_publications_;
+
+  std::vector<Slot> slots_;
+  BoundedIndexQueue free_slots_;
+  BoundedIndexQueue ready_slots_;
+  std::atomic<size_t> ready_count_;
+  std::atomic<uint64_t> dropped_;
+  DDS::GuardCondition condition_;
+  ConnextWaitNotifier * wait_notifier_;
+};
+
+#endif  // SUBSCRIPTION_PUSH_QUEUE_HPP_
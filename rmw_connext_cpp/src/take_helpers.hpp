@@ -0,0 +1,24 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef TAKE_HELPERS_HPP_
+#define TAKE_HELPERS_HPP_
+
+#include "rmw_connext_shared_cpp/ndds_include.hpp"
+
+/// Return true if the sample has been sent from the participant of the reader.
+bool
+is_local_publication(DDS::DataReader * data_reader, const DDS::SampleInfo & sample_info);
+
+#endif  // TAKE_HELPERS_HPP_
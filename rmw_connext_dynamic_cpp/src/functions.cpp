@@ -79,6 +79,7 @@
 #include "rmw_connext_shared_cpp/shared_functions.hpp"
 #include "rmw_connext_shared_cpp/topic_endpoint_info.hpp"
 #include "rmw_connext_shared_cpp/types.hpp"
+#include "rmw_connext_shared_cpp/wait_notifier.hpp"
 
 #include "./macros.hpp"
 #include "./publish_take.hpp"
@@ -159,6 +160,16 @@ struct CustomSubscriberInfo
   DDS_TypeCode * type_code_;
   const void * untyped_members_;
   DDS_DynamicData * dynamic_data;
+
+  DDSCondition * get_wait_condition()
+  {
+    return read_condition_;
+  }
+  /// No notifier, waits always use the DDS wait set.
+  ConnextWaitNotifier * get_wait_notifier()
+  {
+    return nullptr;
+  }
 };
 
 struct ConnextDynamicServiceInfo
@@ -173,6 +184,12 @@ struct ConnextDynamicServiceInfo
   DDS_TypeCode * request_type_code_;
   const void * untyped_request_members_;
   const void * untyped_response_members_;
+
+  /// No notifier, waits always use the DDS wait set.
+  ConnextWaitNotifier * get_wait_notifier()
+  {
+    return nullptr;
+  }
 };
 
 struct ConnextDynamicClientInfo
@@ -187,6 +204,12 @@ struct ConnextDynamicClientInfo
   DDS_TypeCode * request_type_code_;
   const void * untyped_request_members_;
   const void * untyped_response_members_;
+
+  /// No notifier, waits always use the DDS wait set.
+  ConnextWaitNotifier * get_wait_notifier()
+  {
+    return nullptr;
+  }
 };
 
 
@@ -885,6 +908,8 @@ rmw_destroy_publisher(rmw_node_t * node, rmw_publisher_t * publisher)
     if (dds_publisher) {
       auto data_writer = custom_publisher_info->data_writer_;
       if (data_writer) {
+        // the status condition stays attached to the wait sets which waited on it last
+        detach_from_wait_sets(data_writer->get_statuscondition());
         if (dds_publisher->delete_datawriter(data_writer) != DDS_RETCODE_OK) {
           RMW_SET_ERROR_MSG("failed to delete datawriter");
           return RMW_RET_ERROR;
@@ -1384,8 +1409,11 @@ rmw_destroy_subscription(rmw_node_t * node, rmw_subscription_t * subscription)
     if (dds_subscriber) {
       auto data_reader = custom_subscription_info->data_reader_;
       if (data_reader) {
+        // conditions stay attached to the wait sets which waited on them last
+        detach_from_wait_sets(data_reader->get_statuscondition());
         auto read_condition = custom_subscription_info->read_condition_;
         if (read_condition) {
+          detach_from_wait_sets(read_condition);
           if (data_reader->delete_readcondition(read_condition) != DDS_RETCODE_OK) {
             RMW_SET_ERROR_MSG("failed to delete readcondition");
             return RMW_RET_ERROR;
@@ -2007,6 +2035,8 @@ rmw_destroy_client(rmw_node_t * node, rmw_client_t * client)
     auto response_datareader = client_info->response_datareader_;
     if (response_datareader) {
       auto read_condition = client_info->read_condition_;
+      // the condition stays attached to the wait sets which waited on it last
+      detach_from_wait_sets(read_condition);
       if (response_datareader->delete_readcondition(read_condition) != DDS_RETCODE_OK) {
         RMW_SET_ERROR_MSG("failed to delete readcondition");
         return RMW_RET_ERROR;
@@ -2393,6 +2423,8 @@ rmw_destroy_service(rmw_node_t * node, rmw_service_t * service)
     auto request_datareader = service_info->request_datareader_;
     if (request_datareader) {
       auto read_condition = service_info->read_condition_;
+      // the condition stays attached to the wait sets which waited on it last
+      detach_from_wait_sets(read_condition);
       if (request_datareader->delete_readcondition(read_condition) != DDS_RETCODE_OK) {
         RMW_SET_ERROR_MSG("failed to delete readcondition");
         return RMW_RET_ERROR;
@@ -0,0 +1,98 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_CONNEXT_SHARED_CPP__CONNEXT_GUARD_CONDITION_HPP_
+#define RMW_CONNEXT_SHARED_CPP__CONNEXT_GUARD_CONDITION_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include "ndds_include.hpp"
+
+#include "rmw_connext_shared_cpp/visibility_control.h"
+#include "rmw_connext_shared_cpp/wait_notifier.hpp"
+
+/// Guard condition of rmw, triggered without calling into DDS while no wait set waits on it.
+/**
+ * The trigger is an atomic flag, which wait sets check before blocking.
+ * Only while a wait set is blocked is the guard condition of that wait set
+ * triggered as well to wake it up, so that a wait set needs a single DDS
+ * condition for any number of guard conditions.
+ * Epoll wait sets are woken up through the notifier instead.
+ */
+class ConnextGuardCondition
+{
+public:
+  ConnextGuardCondition();
+
+  /// Create the notifier, see ConnextWaitNotifier::init().
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  bool
+  init();
+
+  /// Set the trigger and wake the waiting wait sets, if any.
+  /**
+   * \return false if a wait set could not be woken up
+   */
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  bool
+  trigger();
+
+  /// Clear the trigger.
+  /**
+   * \return whether the trigger was set
+   */
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  bool
+  take_trigger();
+
+  /// Return whether the trigger is set, without clearing it.
+  bool
+  is_triggered() const
+  {
+    return triggered_;
+  }
+
+  /// Notifier of epoll wait sets, notified by trigger().
+  ConnextWaitNotifier *
+  get_wait_notifier()
+  {
+    return &wait_notifier_;
+  }
+
+  /// Have a wait set woken up through its condition when triggered, see trigger().
+  /**
+   * \return whether the trigger is already set, in which case the wait set shouldn't block
+   */
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  bool
+  add_waiter(DDS::GuardCondition * waiter);
+
+  /// Stop waking a wait set added with add_waiter().
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  void
+  remove_waiter(DDS::GuardCondition * waiter);
+
+private:
+  std::atomic<bool> triggered_;
+  // Checked before taking the lock, so that triggering costs nothing more while nobody waits.
+  std::atomic<size_t> waiter_count_;
+  std::mutex waiters_mutex_;
+  std::vector<DDS::GuardCondition *> waiters_;
+  ConnextWaitNotifier wait_notifier_;
+};
+
+#endif  // RMW_CONNEXT_SHARED_CPP__CONNEXT_GUARD_CONDITION_HPP_
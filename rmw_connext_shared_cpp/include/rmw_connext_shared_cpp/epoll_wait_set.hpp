@@ -0,0 +1,89 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_CONNEXT_SHARED_CPP__EPOLL_WAIT_SET_HPP_
+#define RMW_CONNEXT_SHARED_CPP__EPOLL_WAIT_SET_HPP_
+
+#include <mutex>
+#include <vector>
+
+#include "rmw/types.h"
+
+#include "rmw_connext_shared_cpp/visibility_control.h"
+#include "rmw_connext_shared_cpp/wait_notifier.hpp"
+
+/// Wait backend polling the notifiers of the waited entities with a single epoll_wait().
+/**
+ * Notifiers stay registered between waits, only changes of the requested notifiers
+ * are applied. Waking up only means that an entity may have become ready,
+ * the caller checks the entities themselves.
+ * Only available on Linux, init() fails elsewhere.
+ */
+class ConnextEpollWaitSet
+{
+public:
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  ConnextEpollWaitSet();
+
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  ~ConnextEpollWaitSet();
+
+  /// Create the epoll instance.
+  /**
+   * \return false if it could not be created, with the error message set
+   */
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  bool
+  init();
+
+  /// Register the requested notifiers and unregister those which are no longer requested.
+  /**
+   * On failure every notifier is unregistered.
+   */
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  rmw_ret_t
+  update_registered_notifiers();
+
+  /// Block until a registered notifier is notified.
+  /**
+   * \param timeout_ms the timeout in milliseconds, -1 to block indefinitely
+   * \return RMW_RET_OK if woken up, even spuriously, or RMW_RET_TIMEOUT
+   */
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  rmw_ret_t
+  wait(int timeout_ms);
+
+  /// Unregister a notifier which is being destroyed.
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  void
+  remove_notifier(ConnextWaitNotifier * notifier);
+
+  /// Notifiers requested by the current wait, filled before update_registered_notifiers().
+  std::vector<ConnextWaitNotifier *> requested_notifiers;
+
+private:
+  // Unregister everything, the caller holds mutex_.
+  void
+  remove_all_notifiers();
+
+  int epoll_fd_;
+  // Protects the registered notifiers, which are also removed when a notifier is destroyed.
+  std::mutex mutex_;
+  std::vector<ConnextWaitNotifier *> last_requested_notifiers_;
+  // Sorted.
+  std::vector<ConnextWaitNotifier *> registered_notifiers_;
+  std::vector<ConnextWaitNotifier *> requested_notifier_set_;
+};
+
+#endif  // RMW_CONNEXT_SHARED_CPP__EPOLL_WAIT_SET_HPP_
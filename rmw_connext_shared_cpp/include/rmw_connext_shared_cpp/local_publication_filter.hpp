@@ -0,0 +1,111 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_CONNEXT_SHARED_CPP__LOCAL_PUBLICATION_FILTER_HPP_
+#define RMW_CONNEXT_SHARED_CPP__LOCAL_PUBLICATION_FILTER_HPP_
+
+#include <cstddef>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "ndds_include.hpp"
+#include "ndds/ndds_cpp.h"
+#include "ndds/ndds_namespace_cpp.h"
+
+#include "rmw_connext_shared_cpp/visibility_control.h"
+
+/// Keeps the local publications ignored by readers from being delivered at all.
+/**
+ * Only for readers which opt in, since DDS can only ignore a publication for the
+ * whole participant and never stop ignoring it again.
+ * The local writers of a topic are ignored while an opted in reader exists and every
+ * reader of the topic in the participant ignores local publications.
+ * Readers added later still receive nothing from writers which are already ignored.
+ * Writers are ignored when registered, on the thread creating the reader or writer,
+ * never from a listener.
+ * Samples of writers which aren't ignored still need to be dropped by the reader.
+ */
+class LocalPublicationFilter
+{
+public:
+  /// Register a reader of the participant, ignoring the local writers of its topic if due.
+  /**
+   * \param participant the participant of the reader
+   * \param topic_name the name of the DDS topic of the reader
+   * \param ignore_local_publications whether the reader ignores local publications
+   * \param ignore_in_participant whether the reader wants local writers to be ignored
+   *   by the participant, only honored if it ignores local publications
+   */
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  void
+  add_reader(
+    DDS::DomainParticipant * participant,
+    const std::string & topic_name,
+    bool ignore_local_publications,
+    bool ignore_in_participant);
+
+  /// Unregister a reader registered with add_reader(), with the same arguments.
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  void
+  remove_reader(
+    const std::string & topic_name,
+    bool ignore_local_publications,
+    bool ignore_in_participant);
+
+  /// Register a writer of the participant, ignoring it if due.
+  /**
+   * \param participant the participant of the writer
+   * \param topic_name the name of the DDS topic of the writer
+   * \param publication_handle the instance handle of the writer
+   */
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  void
+  add_writer(
+    DDS::DomainParticipant * participant,
+    const std::string & topic_name,
+    const DDS::InstanceHandle_t & publication_handle);
+
+  /// Unregister a writer registered with add_writer().
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  void
+  remove_writer(
+    const std::string & topic_name,
+    const DDS::InstanceHandle_t & publication_handle);
+
+private:
+  struct LocalWriter
+  {
+    DDS::InstanceHandle_t publication_handle;
+    bool ignored;
+  };
+
+  struct TopicEntities
+  {
+    size_t readers = 0;
+    size_t readers_wanting_local = 0;
+    size_t readers_ignoring_in_participant = 0;
+    std::vector<LocalWriter> writers;
+  };
+
+  // Ignore the writers of a topic which aren't ignored yet, if due.
+  static void
+  ignore_local_writers(DDS::DomainParticipant * participant, TopicEntities & topic);
+
+  std::mutex mutex_;
+  std::map<std::string, TopicEntities> topics_;
+};
+
+#endif  // RMW_CONNEXT_SHARED_CPP__LOCAL_PUBLICATION_FILTER_HPP_
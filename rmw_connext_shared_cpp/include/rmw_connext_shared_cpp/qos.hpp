@@ -16,6 +16,7 @@
 #define RMW_CONNEXT_SHARED_CPP__QOS_HPP_
 
 #include <cassert>
+#include <cstdint>
 #include <limits>
 
 #include "ndds_include.hpp"
@@ -39,6 +40,75 @@ get_datawriter_qos(
   const rmw_qos_profile_t & qos_profile,
   DDS::DataWriterQos & datawriter_qos);
 
+/// Publish mode of a data writer.
+enum class ConnextPublishMode
+{
+  /// Choose based on ConnextDataWriterQosOptions::max_serialized_size.
+  automatic,
+  /// Send from within write(), which avoids the hand-off to the publisher's thread.
+  synchronous,
+  /// Send from the publisher's thread, paced by the default flow controller.
+  asynchronous
+};
+
+/// Largest sample the automatic publish mode sends synchronously.
+/**
+ * Leaves room for the RTPS headers within a single UDP datagram,
+ * larger samples need to be fragmented which is better done asynchronously.
+ */
+constexpr size_t connext_max_synchronous_sample_size = 64000;
+
+/// Data writer settings which can't be expressed by a rmw_qos_profile_t.
+struct ConnextDataWriterQosOptions
+{
+  ConnextPublishMode publish_mode = ConnextPublishMode::automatic;
+  /// Largest serialized sample of the written type, 0 if unbounded or unknown.
+  /**
+   * The automatic publish mode is synchronous if this is between 1 and
+   * connext_max_synchronous_sample_size, otherwise asynchronous.
+   */
+  size_t max_serialized_size = 0;
+  /// Collect samples into batches before putting them on the wire.
+  /**
+   * Batching requires the synchronous publish mode, which is used unless another one is requested.
+   * A batch is sent as soon as any of the following limits is reached.
+   */
+  bool batch_enable = false;
+  /// Maximum number of samples in a batch, 0 for unlimited.
+  int32_t batch_max_samples = 0;
+  /// Maximum number of serialized bytes in a batch, 0 for the Connext default.
+  int32_t batch_max_data_bytes = 0;
+  /// Maximum time a sample stays in a batch before it is sent, zero for no limit.
+  rmw_time_t batch_max_flush_delay = {0, 0};
+};
+
+RMW_CONNEXT_SHARED_CPP_PUBLIC
+bool
+get_datawriter_qos(
+  DDS::DomainParticipant * participant,
+  const rmw_qos_profile_t & qos_profile,
+  const ConnextDataWriterQosOptions & options,
+  DDS::DataWriterQos & datawriter_qos);
+
+/// Data reader settings which can't be expressed by a rmw_qos_profile_t.
+struct ConnextDataReaderQosOptions
+{
+  /// Minimum time between samples delivered per instance, zero to deliver every sample.
+  /**
+   * Matched writers don't send samples the reader would filter when possible.
+   * Must not be longer than the deadline of the qos profile.
+   */
+  rmw_time_t minimum_separation = {0, 0};
+};
+
+RMW_CONNEXT_SHARED_CPP_PUBLIC
+bool
+get_datareader_qos(
+  DDS::DomainParticipant * participant,
+  const rmw_qos_profile_t & qos_profile,
+  const ConnextDataReaderQosOptions & options,
+  DDS::DataReaderQos & datareader_qos);
+
 template<typename AttributeT>
 void
 dds_qos_to_rmw_qos(
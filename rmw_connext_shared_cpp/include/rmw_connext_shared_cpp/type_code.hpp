@@ -0,0 +1,56 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_CONNEXT_SHARED_CPP__TYPE_CODE_HPP_
+#define RMW_CONNEXT_SHARED_CPP__TYPE_CODE_HPP_
+
+#include <cstddef>
+
+#include "ndds_include.hpp"
+#include "ndds/ndds_cpp.h"
+#include "ndds/ndds_namespace_cpp.h"
+
+#include "rmw_connext_shared_cpp/visibility_control.h"
+
+/// Compute the largest CDR serialized size of a sample of the given type.
+/**
+ * The returned size includes the encapsulation header which precedes every
+ * serialized sample and is an upper bound, padding is accounted for pessimistically.
+ *
+ * \param type_code the type to inspect
+ * \param[out] max_size the largest serialized size, only set on success
+ * \return false if the type contains unbounded strings or sequences, kinds
+ *   which are not generated for ROS messages or exceeds the size of a sample
+ */
+RMW_CONNEXT_SHARED_CPP_PUBLIC
+bool
+get_serialized_sample_max_size(const DDS_TypeCode * type_code, size_t & max_size);
+
+/// Compute the memory layout of the message struct generated for a plain type.
+/**
+ * A type is plain if it consists only of primitives, fixed size arrays and nested
+ * plain types.
+ * The C and C++ message structs generated for such a type have the natural layout
+ * of their members and can be zero initialized.
+ *
+ * \param type_code the type to inspect
+ * \param[out] size the size of the message struct, only set on success
+ * \param[out] alignment the alignment of the message struct, only set on success
+ * \return false if the type is not plain
+ */
+RMW_CONNEXT_SHARED_CPP_PUBLIC
+bool
+get_plain_type_layout(const DDS_TypeCode * type_code, size_t & size, size_t & alignment);
+
+#endif  // RMW_CONNEXT_SHARED_CPP__TYPE_CODE_HPP_
@@ -16,6 +16,7 @@
 #define RMW_CONNEXT_SHARED_CPP__TYPES_HPP_
 
 #include <cassert>
+#include <cstdint>
 #include <exception>
 #include <iostream>
 #include <limits>
@@ -26,15 +27,21 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "rmw/rmw.h"
 #include "topic_cache.hpp"
+#include "rmw_connext_shared_cpp/local_publication_filter.hpp"
 #include "rmw_connext_shared_cpp/ndds_include.hpp"
 #include "rmw_connext_shared_cpp/visibility_control.h"
 
 
 enum EntityType {Publisher, Subscriber};
 
+class ConnextEpollWaitSet;
+
 class CustomDataReaderListener
   : public DDS::DataReaderListener
 {
@@ -132,6 +139,7 @@ struct ConnextNodeInfo
   CustomPublisherListener * publisher_listener;
   CustomSubscriberListener * subscriber_listener;
   rmw_guard_condition_t * graph_guard_condition;
+  LocalPublicationFilter local_publication_filter;
 };
 
 struct ConnextPublisherGID
@@ -141,9 +149,35 @@ struct ConnextPublisherGID
 
 struct ConnextWaitSetInfo
 {
-  DDS::WaitSet * wait_set;
-  DDS::ConditionSeq * active_conditions;
-  DDS::ConditionSeq * attached_conditions;
+  DDS::WaitSet * wait_set = nullptr;
+  DDS::ConditionSeq * active_conditions = nullptr;
+  DDS::ConditionSeq * attached_conditions = nullptr;
+
+  /// Conditions requested by the current wait, filled by wait() before calling
+  /// update_attached_conditions().
+  std::vector<DDS::Condition *> requested_conditions;
+  /// Conditions requested by the previous wait, in the order they were requested.
+  std::vector<DDS::Condition *> last_requested_conditions;
+  /// Conditions attached to the wait set, sorted, they stay attached between waits.
+  std::vector<DDS::Condition *> attached_condition_set;
+  /// Scratch storage for the sorted requested conditions.
+  std::vector<DDS::Condition *> requested_condition_set;
+  /// Index of the first request of every requested condition, its slot.
+  std::unordered_map<DDS::Condition *, size_t> condition_slots;
+  /// Slot of the condition of every request.
+  std::vector<size_t> request_slots;
+  /// Whether the condition of a slot was active when the last wait returned.
+  std::vector<uint8_t> triggered_slots;
+  /// Statuses requested by the events of the current wait, sorted by status condition.
+  std::vector<std::pair<DDS::StatusCondition *, DDS::StatusMask>> status_masks;
+  /// Statuses enabled for the events of the previous wait.
+  std::vector<std::pair<DDS::StatusCondition *, DDS::StatusMask>> last_status_masks;
+  /// Triggered by the guard conditions of a wait while the wait set is blocked.
+  DDS::GuardCondition guard_wakeup_condition;
+  /// Backend waiting on the notifiers of the entities instead, null to use the DDS wait set.
+  ConnextEpollWaitSet * epoll_wait_set = nullptr;
+  /// Protects the attached conditions, which are also detached when a condition is deleted.
+  std::mutex attached_conditions_mutex;
 };
 
 #endif  // RMW_CONNEXT_SHARED_CPP__TYPES_HPP_
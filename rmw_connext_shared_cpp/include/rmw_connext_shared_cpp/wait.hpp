@@ -15,9 +15,12 @@
 #ifndef RMW_CONNEXT_SHARED_CPP__WAIT_HPP_
 #define RMW_CONNEXT_SHARED_CPP__WAIT_HPP_
 
-#include <unordered_map>
-#include <unordered_set>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <mutex>
 #include <utility>
+#include <vector>
 
 #include "ndds_include.hpp"
 
@@ -26,18 +29,24 @@
 #include "rmw/types.h"
 
 #include "rmw_connext_shared_cpp/condition_error.hpp"
+#include "rmw_connext_shared_cpp/connext_guard_condition.hpp"
+#include "rmw_connext_shared_cpp/epoll_wait_set.hpp"
 #include "rmw_connext_shared_cpp/event_converter.hpp"
 #include "rmw_connext_shared_cpp/types.hpp"
 #include "rmw_connext_shared_cpp/visibility_control.h"
+#include "rmw_connext_shared_cpp/wait_set.hpp"
 #include "rmw_connext_shared_cpp/connext_static_event_info.hpp"
 
 rmw_ret_t
 __gather_event_conditions(
   rmw_events_t * events,
-  std::unordered_set<DDS::StatusCondition *> & status_conditions)
+  ConnextWaitSetInfo * wait_set_info)
 {
   RMW_CHECK_ARGUMENT_FOR_NULL(events, RMW_RET_INVALID_ARGUMENT);
-  std::unordered_map<DDS::StatusCondition *, DDS::StatusMask> status_mask_map;
+  // kept in the wait set, so that waiting on the same events doesn't allocate
+  std::vector<std::pair<DDS::StatusCondition *, DDS::StatusMask>> & status_masks =
+    wait_set_info->status_masks;
+  status_masks.clear();
   // gather all status conditions and masks
   for (size_t i = 0; i < events->event_count; ++i) {
     auto current_event = static_cast<rmw_event_t *>(events->events[i]);
@@ -54,21 +63,36 @@ __gather_event_conditions(
       return RMW_RET_ERROR;
     }
     if (is_event_supported(current_event->event_type)) {
-      auto map_pair = status_mask_map.insert(
-        std::pair<DDS::StatusCondition *, DDS::StatusMask>(
-          status_condition, DDS::STATUS_MASK_NONE));
-      auto iterator = map_pair.first;
-      status_mask_map[status_condition] = get_status_kind_from_rmw(current_event->event_type) |
-        (*iterator).second;
-
+      status_masks.emplace_back(
+        status_condition, get_status_kind_from_rmw(current_event->event_type));
     } else {
       RMW_SET_ERROR_MSG_WITH_FORMAT_STRING("event %d not supported", current_event->event_type);
     }
   }
-  for (auto & pair : status_mask_map) {
-    // set the status condition's mask with the supported type
-    pair.first->set_enabled_statuses(pair.second);
-    status_conditions.insert(pair.first);
+  // merge the masks of the events of each status condition
+  std::sort(status_masks.begin(), status_masks.end());
+  size_t status_condition_count = 0;
+  for (const auto & status_mask : status_masks) {
+    if (status_condition_count > 0 &&
+      status_masks[status_condition_count - 1].first == status_mask.first)
+    {
+      status_masks[status_condition_count - 1].second |= status_mask.second;
+    } else {
+      status_masks[status_condition_count++] = status_mask;
+    }
+  }
+  status_masks.resize(status_condition_count);
+
+  // the enabled statuses only change with the events
+  std::lock_guard<std::mutex> lock(wait_set_info->attached_conditions_mutex);
+  if (status_masks != wait_set_info->last_status_masks) {
+    for (const auto & status_mask : status_masks) {
+      // set the status condition's mask with the supported type
+      if (status_mask.first->get_enabled_statuses() != status_mask.second) {
+        status_mask.first->set_enabled_statuses(status_mask.second);
+      }
+    }
+    wait_set_info->last_status_masks = status_masks;
   }
   return RMW_RET_OK;
 }
@@ -104,87 +128,215 @@ rmw_ret_t __handle_active_event_conditions(rmw_events_t * events)
   return RMW_RET_OK;
 }
 
-rmw_ret_t __detach_condition(
-  DDS::WaitSet * dds_wait_set,
-  DDS::Condition * condition)
+template<typename SubscriberInfo, typename ServiceInfo, typename ClientInfo>
+bool
+__gather_wait_notifiers(
+  rmw_subscriptions_t * subscriptions,
+  rmw_guard_conditions_t * guard_conditions,
+  rmw_services_t * services,
+  rmw_clients_t * clients,
+  std::vector<ConnextWaitNotifier *> & requested_notifiers)
 {
-  DDS::ReturnCode_t dds_return_code = dds_wait_set->detach_condition(condition);
-  rmw_ret_t from_dds = check_dds_ret_code(dds_return_code);
-  if (from_dds != RMW_RET_OK) {
-    RMW_SET_ERROR_MSG("Failed to get detach condition from wait set");
-    return from_dds;
+  requested_notifiers.clear();
+  // entities without a notifier can only be waited on with the DDS wait set,
+  // which also reports invalid handles
+  auto add = [&requested_notifiers](ConnextWaitNotifier * notifier) {
+      if (!notifier || notifier->get_fd() < 0) {
+        return false;
+      }
+      requested_notifiers.push_back(notifier);
+      return true;
+    };
+  if (subscriptions) {
+    for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
+      auto subscriber_info = static_cast<SubscriberInfo *>(subscriptions->subscribers[i]);
+      if (
+        !subscriber_info || !subscriber_info->get_wait_condition() ||
+        !add(subscriber_info->get_wait_notifier()))
+      {
+        return false;
+      }
+    }
   }
-  return RMW_RET_OK;
+  if (guard_conditions) {
+    for (size_t i = 0; i < guard_conditions->guard_condition_count; ++i) {
+      auto guard_condition =
+        static_cast<ConnextGuardCondition *>(guard_conditions->guard_conditions[i]);
+      if (!guard_condition || !add(guard_condition->get_wait_notifier())) {
+        return false;
+      }
+    }
+  }
+  if (services) {
+    for (size_t i = 0; i < services->service_count; ++i) {
+      auto service_info = static_cast<ServiceInfo *>(services->services[i]);
+      if (
+        !service_info || !service_info->read_condition_ ||
+        !add(service_info->get_wait_notifier()))
+      {
+        return false;
+      }
+    }
+  }
+  if (clients) {
+    for (size_t i = 0; i < clients->client_count; ++i) {
+      auto client_info = static_cast<ClientInfo *>(clients->clients[i]);
+      if (
+        !client_info || !client_info->read_condition_ ||
+        !add(client_info->get_wait_notifier()))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template<typename SubscriberInfo, typename ServiceInfo, typename ClientInfo>
+bool
+__is_any_ready(
+  rmw_subscriptions_t * subscriptions,
+  rmw_guard_conditions_t * guard_conditions,
+  rmw_services_t * services,
+  rmw_clients_t * clients)
+{
+  if (subscriptions) {
+    for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
+      auto subscriber_info = static_cast<SubscriberInfo *>(subscriptions->subscribers[i]);
+      if (subscriber_info->get_wait_condition()->get_trigger_value()) {
+        return true;
+      }
+    }
+  }
+  if (guard_conditions) {
+    for (size_t i = 0; i < guard_conditions->guard_condition_count; ++i) {
+      auto guard_condition =
+        static_cast<ConnextGuardCondition *>(guard_conditions->guard_conditions[i]);
+      if (guard_condition->is_triggered()) {
+        return true;
+      }
+    }
+  }
+  if (services) {
+    for (size_t i = 0; i < services->service_count; ++i) {
+      auto service_info = static_cast<ServiceInfo *>(services->services[i]);
+      if (service_info->read_condition_->get_trigger_value()) {
+        return true;
+      }
+    }
+  }
+  if (clients) {
+    for (size_t i = 0; i < clients->client_count; ++i) {
+      auto client_info = static_cast<ClientInfo *>(clients->clients[i]);
+      if (client_info->read_condition_->get_trigger_value()) {
+        return true;
+      }
+    }
+  }
+  return false;
 }
 
 template<typename SubscriberInfo, typename ServiceInfo, typename ClientInfo>
 rmw_ret_t
-wait(
-  const char * implementation_identifier,
+__wait_epoll(
   rmw_subscriptions_t * subscriptions,
   rmw_guard_conditions_t * guard_conditions,
   rmw_services_t * services,
   rmw_clients_t * clients,
-  rmw_events_t * events,
-  rmw_wait_set_t * wait_set,
+  ConnextEpollWaitSet * epoll_wait_set,
   const rmw_time_t * wait_timeout)
 {
-  // To ensure that we properly clean up the wait set, we declare an
-  // object whose destructor will detach what we attached (this was previously
-  // being done inside the destructor of the wait set.
-  struct atexit_t
+  rmw_ret_t ret_code = epoll_wait_set->update_registered_notifiers();
+  if (ret_code != RMW_RET_OK) {
+    return ret_code;
+  }
+
+  // notifiers are registered before checking the entities, so nothing becoming ready
+  // in between is missed
+  using std::chrono::steady_clock;
+  const bool infinite = !wait_timeout;
+  steady_clock::time_point deadline;
+  if (!infinite) {
+    deadline = steady_clock::now() + std::chrono::seconds(wait_timeout->sec) +
+      std::chrono::nanoseconds(wait_timeout->nsec);
+  }
+  while (!__is_any_ready<SubscriberInfo, ServiceInfo, ClientInfo>(
+      subscriptions, guard_conditions, services, clients))
   {
-    ~atexit_t()
-    {
-      // Manually detach conditions and clear sequences, to ensure a clean wait set for next time.
-      if (!wait_set) {
-        RMW_SET_ERROR_MSG("wait set handle is null");
-        return;
-      }
-      RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
-        wait set handle,
-        wait_set->implementation_identifier, implementation_identifier,
-        return )
-      auto wait_set_info = static_cast<ConnextWaitSetInfo *>(wait_set->data);
-      if (!wait_set_info) {
-        RMW_SET_ERROR_MSG("WaitSet implementation struct is null");
-        return;
-      }
+    int timeout_ms = -1;
+    if (!infinite) {
+      auto remaining = deadline - steady_clock::now();
+      if (remaining <= steady_clock::duration::zero()) {
+        break;
+      }
+      // round up, so that the deadline has passed when epoll times out
+      auto remaining_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(remaining).count() + 1;
+      timeout_ms = remaining_ms > INT_MAX ? INT_MAX : static_cast<int>(remaining_ms);
+    }
+    ret_code = epoll_wait_set->wait(timeout_ms);
+    if (ret_code == RMW_RET_ERROR) {
+      return ret_code;
+    }
+  }
 
-      DDS::WaitSet * dds_wait_set = wait_set_info->wait_set;
-      if (!dds_wait_set) {
-        RMW_SET_ERROR_MSG("DDS wait set handle is null");
-        return;
+  bool any_ready = false;
+  if (subscriptions) {
+    for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
+      auto subscriber_info = static_cast<SubscriberInfo *>(subscriptions->subscribers[i]);
+      if (subscriber_info->get_wait_condition()->get_trigger_value()) {
+        any_ready = true;
+      } else {
+        subscriptions->subscribers[i] = nullptr;
       }
-
-      DDS::ConditionSeq * attached_conditions = wait_set_info->attached_conditions;
-      if (!attached_conditions) {
-        RMW_SET_ERROR_MSG("DDS condition sequence handle is null");
-        return;
+    }
+  }
+  if (guard_conditions) {
+    for (size_t i = 0; i < guard_conditions->guard_condition_count; ++i) {
+      auto guard_condition =
+        static_cast<ConnextGuardCondition *>(guard_conditions->guard_conditions[i]);
+      if (guard_condition->take_trigger()) {
+        any_ready = true;
+      } else {
+        guard_conditions->guard_conditions[i] = nullptr;
       }
-
-      DDS::ReturnCode_t retcode;
-      retcode = dds_wait_set->get_conditions(*attached_conditions);
-      if (retcode != DDS::RETCODE_OK) {
-        RMW_SET_ERROR_MSG("Failed to get attached conditions for wait set");
-        return;
+    }
+  }
+  if (services) {
+    for (size_t i = 0; i < services->service_count; ++i) {
+      auto service_info = static_cast<ServiceInfo *>(services->services[i]);
+      if (service_info->read_condition_->get_trigger_value()) {
+        any_ready = true;
+      } else {
+        services->services[i] = nullptr;
       }
-
-      for (DDS::Long i = 0; i < attached_conditions->length(); ++i) {
-        auto rmw_ret_code = __detach_condition(dds_wait_set, (*attached_conditions)[i]);
-        if (rmw_ret_code != RMW_RET_OK) {
-          RMW_SET_ERROR_MSG("Failed to get detatch conditions for wait set");
-          return;
-        }
+    }
+  }
+  if (clients) {
+    for (size_t i = 0; i < clients->client_count; ++i) {
+      auto client_info = static_cast<ClientInfo *>(clients->clients[i]);
+      if (client_info->read_condition_->get_trigger_value()) {
+        any_ready = true;
+      } else {
+        clients->clients[i] = nullptr;
       }
     }
-    rmw_wait_set_t * wait_set = nullptr;
-    const char * implementation_identifier = nullptr;
-  } atexit;
-
-  atexit.wait_set = wait_set;
-  atexit.implementation_identifier = implementation_identifier;
+  }
+  return any_ready ? RMW_RET_OK : RMW_RET_TIMEOUT;
+}
 
+template<typename SubscriberInfo, typename ServiceInfo, typename ClientInfo>
+rmw_ret_t
+wait(
+  const char * implementation_identifier,
+  rmw_subscriptions_t * subscriptions,
+  rmw_guard_conditions_t * guard_conditions,
+  rmw_services_t * services,
+  rmw_clients_t * clients,
+  rmw_events_t * events,
+  rmw_wait_set_t * wait_set,
+  const rmw_time_t * wait_timeout)
+{
   if (!wait_set) {
     RMW_SET_ERROR_MSG("wait set handle is null");
     return RMW_RET_ERROR;
@@ -200,6 +352,18 @@ wait(
     return RMW_RET_ERROR;
   }
 
+  // events are only delivered through status conditions of the DDS wait set
+  ConnextEpollWaitSet * epoll_wait_set = wait_set_info->epoll_wait_set;
+  if (
+    epoll_wait_set && (!events || events->event_count == 0) &&
+    __gather_wait_notifiers<SubscriberInfo, ServiceInfo, ClientInfo>(
+      subscriptions, guard_conditions, services, clients,
+      epoll_wait_set->requested_notifiers))
+  {
+    return __wait_epoll<SubscriberInfo, ServiceInfo, ClientInfo>(
+      subscriptions, guard_conditions, services, clients, epoll_wait_set, wait_timeout);
+  }
+
   DDS::WaitSet * dds_wait_set = wait_set_info->wait_set;
   if (!dds_wait_set) {
     RMW_SET_ERROR_MSG("DDS wait set handle is null");
@@ -212,7 +376,12 @@ wait(
     return RMW_RET_ERROR;
   }
 
+  // gather the conditions to wait on, only changes are applied to the wait set
+  std::vector<DDS::Condition *> & requested_conditions = wait_set_info->requested_conditions;
+  requested_conditions.clear();
+
   // add a condition for each subscriber
+  const size_t subscriptions_offset = requested_conditions.size();
   if (subscriptions) {
     for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
       auto subscriber_info =
@@ -221,52 +390,40 @@ wait(
         RMW_SET_ERROR_MSG("subscriber info handle is null");
         return RMW_RET_ERROR;
       }
-      DDS::ReadCondition * read_condition = subscriber_info->read_condition_;
-      if (!read_condition) {
-        RMW_SET_ERROR_MSG("read condition handle is null");
+      DDS::Condition * condition = subscriber_info->get_wait_condition();
+      if (!condition) {
+        RMW_SET_ERROR_MSG("subscriber condition handle is null");
         return RMW_RET_ERROR;
       }
-      rmw_ret_t rmw_status = check_attach_condition_error(
-        dds_wait_set->attach_condition(read_condition));
-      if (rmw_status != RMW_RET_OK) {
-        return rmw_status;
-      }
+      requested_conditions.push_back(condition);
     }
   }
 
-  std::unordered_set<DDS::StatusCondition *> status_conditions;
   // gather all status conditions with set masks
-  rmw_ret_t ret_code = __gather_event_conditions(events, status_conditions);
+  rmw_ret_t ret_code = __gather_event_conditions(events, wait_set_info);
   if (ret_code != RMW_RET_OK) {
     return ret_code;
   }
   // enable a status condition for each event
-  for (auto status_condition : status_conditions) {
-    rmw_ret_t rmw_status = check_attach_condition_error(
-      dds_wait_set->attach_condition(status_condition));
-    if (rmw_status != RMW_RET_OK) {
-      return rmw_status;
-    }
+  for (const auto & status_mask : wait_set_info->status_masks) {
+    requested_conditions.push_back(status_mask.first);
   }
 
-  // add a condition for each guard condition
+  // add a single condition waking the wait set up for all guard conditions
   if (guard_conditions) {
     for (size_t i = 0; i < guard_conditions->guard_condition_count; ++i) {
-      auto guard_condition =
-        static_cast<DDS::GuardCondition *>(guard_conditions->guard_conditions[i]);
-      if (!guard_condition) {
+      if (!guard_conditions->guard_conditions[i]) {
         RMW_SET_ERROR_MSG("guard condition handle is null");
         return RMW_RET_ERROR;
       }
-      rmw_ret_t rmw_status = check_attach_condition_error(
-        dds_wait_set->attach_condition(guard_condition));
-      if (rmw_status != RMW_RET_OK) {
-        return rmw_status;
-      }
+    }
+    if (guard_conditions->guard_condition_count > 0) {
+      requested_conditions.push_back(&wait_set_info->guard_wakeup_condition);
     }
   }
 
   // add a condition for each service
+  const size_t services_offset = requested_conditions.size();
   if (services) {
     for (size_t i = 0; i < services->service_count; ++i) {
       auto service_info =
@@ -282,15 +439,12 @@ wait(
         RMW_SET_ERROR_MSG("read condition handle is null");
         return RMW_RET_ERROR;
       }
-      rmw_ret_t rmw_status = check_attach_condition_error(
-        dds_wait_set->attach_condition(read_condition));
-      if (rmw_status != RMW_RET_OK) {
-        return rmw_status;
-      }
+      requested_conditions.push_back(read_condition);
     }
   }
 
   // add a condition for each client
+  const size_t clients_offset = requested_conditions.size();
   if (clients) {
     for (size_t i = 0; i < clients->client_count; ++i) {
       auto client_info =
@@ -312,17 +466,34 @@ wait(
         RMW_SET_ERROR_MSG("read condition handle is null");
         return RMW_RET_ERROR;
       }
-      rmw_ret_t rmw_status = check_attach_condition_error(
-        dds_wait_set->attach_condition(read_condition));
-      if (rmw_status != RMW_RET_OK) {
-        return rmw_status;
+      requested_conditions.push_back(read_condition);
+    }
+  }
+
+  ret_code = update_attached_conditions(wait_set_info);
+  if (ret_code != RMW_RET_OK) {
+    return ret_code;
+  }
+
+  // have the guard conditions wake the wait set up while it is blocked
+  bool guard_triggered = false;
+  if (guard_conditions) {
+    for (size_t i = 0; i < guard_conditions->guard_condition_count; ++i) {
+      auto guard_condition =
+        static_cast<ConnextGuardCondition *>(guard_conditions->guard_conditions[i]);
+      if (guard_condition->add_waiter(&wait_set_info->guard_wakeup_condition)) {
+        guard_triggered = true;
       }
     }
   }
 
   // invoke wait until one of the conditions triggers
   DDS::Duration_t timeout;
-  if (!wait_timeout) {
+  if (guard_triggered) {
+    // only gather the other active conditions
+    timeout.sec = 0;
+    timeout.nanosec = 0;
+  } else if (!wait_timeout) {
     timeout.sec = DDS::DURATION_INFINITE_SEC;
     timeout.nanosec = DDS::DURATION_INFINITE_NSEC;
   } else {
@@ -332,145 +503,66 @@ wait(
 
   DDS::ReturnCode_t status = dds_wait_set->wait(*active_conditions, timeout);
 
+  if (guard_conditions) {
+    for (size_t i = 0; i < guard_conditions->guard_condition_count; ++i) {
+      auto guard_condition =
+        static_cast<ConnextGuardCondition *>(guard_conditions->guard_conditions[i]);
+      guard_condition->remove_waiter(&wait_set_info->guard_wakeup_condition);
+    }
+    // no guard condition wakes the wait set up anymore, the triggers themselves stay set
+    if (wait_set_info->guard_wakeup_condition.get_trigger_value()) {
+      wait_set_info->guard_wakeup_condition.set_trigger_value(DDS::BOOLEAN_FALSE);
+    }
+  }
+
   if (status != DDS::RETCODE_OK && status != DDS::RETCODE_TIMEOUT) {
     RMW_SET_ERROR_MSG("failed to wait on wait set");
     return RMW_RET_ERROR;
   }
 
+  // look up the slot of every active condition once instead of searching
+  // the active conditions for every entity
+  mark_triggered_conditions(wait_set_info);
+
   // set subscriber handles to zero for all not triggered conditions
   if (subscriptions) {
     for (size_t i = 0; i < subscriptions->subscriber_count; ++i) {
-      auto subscriber_info =
-        static_cast<SubscriberInfo *>(subscriptions->subscribers[i]);
-      if (!subscriber_info) {
-        RMW_SET_ERROR_MSG("subscriber info handle is null");
-        return RMW_RET_ERROR;
-      }
-      DDS::ReadCondition * read_condition = subscriber_info->read_condition_;
-      if (!read_condition) {
-        RMW_SET_ERROR_MSG("read condition handle is null");
-        return RMW_RET_ERROR;
-      }
-
-      // search for subscriber condition in active set
-      DDS::Long j = 0;
-      for (; j < active_conditions->length(); ++j) {
-        if ((*active_conditions)[j] == read_condition) {
-          break;
-        }
-      }
-      // if subscriber condition is not found in the active set
-      // reset the subscriber handle
-      if (!(j < active_conditions->length())) {
+      if (!is_request_triggered(wait_set_info, subscriptions_offset + i)) {
         subscriptions->subscribers[i] = 0;
       }
-      rmw_ret_t rmw_ret_code = __detach_condition(dds_wait_set, read_condition);
-      if (rmw_ret_code != RMW_RET_OK) {
-        return rmw_ret_code;
-      }
     }
   }
 
   // set guard condition handles to zero for all not triggered conditions
+  // and reset the triggered ones
+  guard_triggered = false;
   if (guard_conditions) {
     for (size_t i = 0; i < guard_conditions->guard_condition_count; ++i) {
-      auto condition =
-        static_cast<DDS::Condition *>(guard_conditions->guard_conditions[i]);
-      if (!condition) {
-        RMW_SET_ERROR_MSG("condition handle is null");
-        return RMW_RET_ERROR;
-      }
-
-      // search for guard condition in active set
-      DDS::Long j = 0;
-      for (; j < active_conditions->length(); ++j) {
-        if ((*active_conditions)[j] == condition) {
-          auto guard = dynamic_cast<DDS::GuardCondition *>(condition);
-          DDS::ReturnCode_t guard_status = guard->set_trigger_value(DDS::BOOLEAN_FALSE);
-          if (guard_status != DDS::RETCODE_OK) {
-            RMW_SET_ERROR_MSG("failed to set trigger value");
-            return RMW_RET_ERROR;
-          }
-          break;
-        }
-      }
-      // if guard condition is not found in the active set
-      // reset the guard handle
-      if (!(j < active_conditions->length())) {
+      auto guard_condition =
+        static_cast<ConnextGuardCondition *>(guard_conditions->guard_conditions[i]);
+      if (guard_condition->take_trigger()) {
+        guard_triggered = true;
+      } else {
         guard_conditions->guard_conditions[i] = nullptr;
       }
-      rmw_ret_t rmw_ret_code = __detach_condition(dds_wait_set, condition);
-      if (rmw_ret_code != RMW_RET_OK) {
-        return rmw_ret_code;
-      }
     }
   }
 
   // set service handles to zero for all not triggered conditions
   if (services) {
     for (size_t i = 0; i < services->service_count; ++i) {
-      auto service_info =
-        static_cast<ServiceInfo *>(services->services[i]);
-      if (!service_info) {
-        RMW_SET_ERROR_MSG("service info handle is null");
-        return RMW_RET_ERROR;
-      }
-      DDS::ReadCondition * read_condition = service_info->read_condition_;
-      if (!read_condition) {
-        RMW_SET_ERROR_MSG("read condition handle is null");
-        return RMW_RET_ERROR;
-      }
-
-      // search for service condition in active set
-      DDS::Long j = 0;
-      for (; j < active_conditions->length(); ++j) {
-        if ((*active_conditions)[j] == read_condition) {
-          break;
-        }
-      }
-      // if service condition is not found in the active set
-      // reset the subscriber handle
-      if (!(j < active_conditions->length())) {
+      if (!is_request_triggered(wait_set_info, services_offset + i)) {
         services->services[i] = nullptr;
       }
-      rmw_ret_t rmw_ret_code = __detach_condition(dds_wait_set, read_condition);
-      if (rmw_ret_code != RMW_RET_OK) {
-        return rmw_ret_code;
-      }
     }
   }
 
   // set client handles to zero for all not triggered conditions
   if (clients) {
     for (size_t i = 0; i < clients->client_count; ++i) {
-      auto client_info =
-        static_cast<ClientInfo *>(clients->clients[i]);
-      if (!client_info) {
-        RMW_SET_ERROR_MSG("client info handle is null");
-        return RMW_RET_ERROR;
-      }
-      DDS::ReadCondition * read_condition = client_info->read_condition_;
-      if (!read_condition) {
-        RMW_SET_ERROR_MSG("read condition handle is null");
-        return RMW_RET_ERROR;
-      }
-
-      // search for service condition in active set
-      DDS::Long j = 0;
-      for (; j < active_conditions->length(); ++j) {
-        if ((*active_conditions)[j] == read_condition) {
-          break;
-        }
-      }
-      // if client condition is not found in the active set
-      // reset the subscriber handle
-      if (!(j < active_conditions->length())) {
+      if (!is_request_triggered(wait_set_info, clients_offset + i)) {
         clients->clients[i] = nullptr;
       }
-      rmw_ret_t rmw_ret_code = __detach_condition(dds_wait_set, read_condition);
-      if (rmw_ret_code != RMW_RET_OK) {
-        return rmw_ret_code;
-      }
     }
   }
   {
@@ -480,7 +572,7 @@ wait(
     }
   }
 
-  if (status == DDS::RETCODE_TIMEOUT) {
+  if (status == DDS::RETCODE_TIMEOUT && !guard_triggered) {
     return RMW_RET_TIMEOUT;
   }
   return RMW_RET_OK;
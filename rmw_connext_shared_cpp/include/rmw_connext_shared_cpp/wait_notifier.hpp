@@ -0,0 +1,103 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef RMW_CONNEXT_SHARED_CPP__WAIT_NOTIFIER_HPP_
+#define RMW_CONNEXT_SHARED_CPP__WAIT_NOTIFIER_HPP_
+
+#include <atomic>
+#include <cstddef>
+
+#include "ndds_include.hpp"
+
+#include "rmw_connext_shared_cpp/visibility_control.h"
+
+/// File descriptor written when an entity may have become ready, for the epoll wait backend.
+/**
+ * The descriptor is an eventfd, which is only written while the notifier is registered
+ * with an epoll wait set. Wait sets register it edge-triggered and never read it, so that
+ * every write wakes up every epoll wait set the notifier is registered with.
+ * Wait sets check the entity itself once woken up, so spurious notifications are harmless.
+ * The notifier can be used as the listener of a data reader to be notified of every sample.
+ * Without eventfd support there is no descriptor and notifying does nothing.
+ */
+class ConnextWaitNotifier : public DDS::DataReaderListener
+{
+public:
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  ConnextWaitNotifier();
+
+  /// Unregister from all epoll wait sets and close the descriptor.
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  virtual ~ConnextWaitNotifier();
+
+  /// Create the descriptor.
+  /**
+   * \return false if the descriptor could not be created, with the error message set
+   */
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  bool
+  init();
+
+  /// Descriptor to poll, -1 if there is none.
+  int
+  get_fd() const
+  {
+    return fd_;
+  }
+
+  /// Write the descriptor if an epoll wait set polls it.
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  void
+  notify();
+
+  /// Count an epoll wait set the notifier is registered with.
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  void
+  add_poller();
+
+  /// Stop counting an epoll wait set added with add_poller().
+  RMW_CONNEXT_SHARED_CPP_PUBLIC
+  void
+  remove_poller();
+
+  void
+  on_data_available(DDS::DataReader * reader) override
+  {
+    (void) reader;
+    notify();
+  }
+
+private:
+  int fd_;
+  // Checked before writing, so that notifying costs nothing while nobody polls.
+  std::atomic<size_t> pollers_;
+};
+
+/// Allocate and initialize a notifier.
+/**
+ * \return the notifier or nullptr on failure, with the error message set
+ */
+RMW_CONNEXT_SHARED_CPP_PUBLIC
+ConnextWaitNotifier *
+create_wait_notifier();
+
+/// Destroy a notifier created with create_wait_notifier().
+/**
+ * A data reader the notifier listens to has to be deleted first.
+ */
+RMW_CONNEXT_SHARED_CPP_PUBLIC
+void
+destroy_wait_notifier(ConnextWaitNotifier * notifier);
+
+#endif  // RMW_CONNEXT_SHARED_CPP__WAIT_NOTIFIER_HPP_
@@ -17,7 +17,10 @@
 
 #include "rmw/types.h"
 
+#include "rmw_connext_shared_cpp/ndds_include.hpp"
+#include "rmw_connext_shared_cpp/types.hpp"
 #include "rmw_connext_shared_cpp/visibility_control.h"
+#include "rmw_connext_shared_cpp/wait_notifier.hpp"
 
 RMW_CONNEXT_SHARED_CPP_PUBLIC
 rmw_wait_set_t *
@@ -30,4 +33,59 @@ RMW_CONNEXT_SHARED_CPP_PUBLIC
 rmw_ret_t
 destroy_wait_set(const char * implementation_identifier, rmw_wait_set_t * wait_set);
 
+/// Attach the conditions requested by a wait and detach those which are no longer requested.
+/**
+ * Conditions stay attached to the DDS wait set between waits, so a wait on the same
+ * entities as the previous one doesn't attach or detach anything.
+ * On failure every condition is detached.
+ * \param wait_set_info wait set whose requested_conditions have been filled
+ * \return RMW_RET_OK if the wait set has exactly the requested conditions attached
+ */
+RMW_CONNEXT_SHARED_CPP_PUBLIC
+rmw_ret_t
+update_attached_conditions(ConnextWaitSetInfo * wait_set_info);
+
+/// Mark the slots of the conditions a wait returned as active.
+RMW_CONNEXT_SHARED_CPP_PUBLIC
+void
+mark_triggered_conditions(ConnextWaitSetInfo * wait_set_info);
+
+/// Return whether the condition of a request of the last wait was active.
+/**
+ * \param request_index index of the condition in the requested conditions of the wait
+ */
+inline bool
+is_request_triggered(const ConnextWaitSetInfo * wait_set_info, size_t request_index)
+{
+  return wait_set_info->triggered_slots[wait_set_info->request_slots[request_index]] != 0;
+}
+
+/// Detach a condition from every wait set it is still attached to.
+/**
+ * Has to be called before deleting a condition which may have been waited on,
+ * including the status conditions of entities, which are deleted with them.
+ */
+RMW_CONNEXT_SHARED_CPP_PUBLIC
+void
+detach_from_wait_sets(DDS::Condition * condition);
+
+/// Select whether a wait set waits with epoll on the notifiers of the entities.
+/**
+ * Waits on entities without a notifier or on events still use the DDS wait set.
+ * Must not be called while the wait set is in use.
+ * \param use_epoll true for the epoll backend, false for the DDS wait set
+ * \return RMW_RET_UNSUPPORTED if epoll isn't available on this platform
+ */
+RMW_CONNEXT_SHARED_CPP_PUBLIC
+rmw_ret_t
+set_wait_set_epoll_backend(
+  const char * implementation_identifier,
+  rmw_wait_set_t * wait_set,
+  bool use_epoll);
+
+/// Unregister a notifier from every epoll wait set, see ConnextWaitNotifier.
+RMW_CONNEXT_SHARED_CPP_PUBLIC
+void
+remove_from_epoll_wait_sets(ConnextWaitNotifier * notifier);
+
 #endif  // RMW_CONNEXT_SHARED_CPP__WAIT_SET_HPP_
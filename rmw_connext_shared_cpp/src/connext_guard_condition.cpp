@@ -0,0 +1,77 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "rmw_connext_shared_cpp/connext_guard_condition.hpp"
+
+ConnextGuardCondition::ConnextGuardCondition()
+: triggered_(false),
+  waiter_count_(0)
+{}
+
+bool
+ConnextGuardCondition::init()
+{
+  return wait_notifier_.init();
+}
+
+bool
+ConnextGuardCondition::trigger()
+{
+  // Sequentially consistent with add_waiter(), either the wait set sees the trigger
+  // before blocking or the waiter is seen here.
+  triggered_ = true;
+  wait_notifier_.notify();
+  if (waiter_count_ == 0) {
+    return true;
+  }
+  bool woken = true;
+  std::lock_guard<std::mutex> lock(waiters_mutex_);
+  for (DDS::GuardCondition * waiter : waiters_) {
+    if (waiter->set_trigger_value(DDS::BOOLEAN_TRUE) != DDS::RETCODE_OK) {
+      woken = false;
+    }
+  }
+  return woken;
+}
+
+bool
+ConnextGuardCondition::take_trigger()
+{
+  // Avoid the read-modify-write while the trigger isn't set, the usual case.
+  return triggered_ && triggered_.exchange(false);
+}
+
+bool
+ConnextGuardCondition::add_waiter(DDS::GuardCondition * waiter)
+{
+  {
+    std::lock_guard<std::mutex> lock(waiters_mutex_);
+    waiters_.push_back(waiter);
+    ++waiter_count_;
+  }
+  return triggered_;
+}
+
+void
+ConnextGuardCondition::remove_waiter(DDS::GuardCondition * waiter)
+{
+  std::lock_guard<std::mutex> lock(waiters_mutex_);
+  auto it = std::find(waiters_.begin(), waiters_.end(), waiter);
+  if (it != waiters_.end()) {
+    waiters_.erase(it);
+    --waiter_count_;
+  }
+}
@@ -0,0 +1,174 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+
+#include "rmw/error_handling.h"
+
+#include "rmw_connext_shared_cpp/epoll_wait_set.hpp"
+
+#ifdef __linux__
+// Notifications reported per epoll_wait(), more are reported by the next one.
+static const int max_epoll_events = 64;
+#endif
+
+static void
+unregister_notifier(int epoll_fd, ConnextWaitNotifier * notifier)
+{
+#ifdef __linux__
+  epoll_ctl(epoll_fd, EPOLL_CTL_DEL, notifier->get_fd(), nullptr);
+#else
+  (void) epoll_fd;
+#endif
+  notifier->remove_poller();
+}
+
+ConnextEpollWaitSet::ConnextEpollWaitSet()
+: epoll_fd_(-1)
+{}
+
+ConnextEpollWaitSet::~ConnextEpollWaitSet()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  remove_all_notifiers();
+#ifdef __linux__
+  if (epoll_fd_ >= 0) {
+    close(epoll_fd_);
+  }
+#endif
+}
+
+bool
+ConnextEpollWaitSet::init()
+{
+#ifdef __linux__
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  if (epoll_fd_ < 0) {
+    RMW_SET_ERROR_MSG("failed to create epoll instance");
+    return false;
+  }
+  return true;
+#else
+  RMW_SET_ERROR_MSG("the epoll wait backend is only available on Linux");
+  return false;
+#endif
+}
+
+rmw_ret_t
+ConnextEpollWaitSet::update_registered_notifiers()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  // executors usually wait on the same entities in the same order over and over
+  if (requested_notifiers == last_requested_notifiers_) {
+    return RMW_RET_OK;
+  }
+
+  std::vector<ConnextWaitNotifier *> & requested = requested_notifier_set_;
+  requested.assign(requested_notifiers.begin(), requested_notifiers.end());
+  std::sort(requested.begin(), requested.end());
+  requested.erase(std::unique(requested.begin(), requested.end()), requested.end());
+
+#ifdef __linux__
+  auto registered_it = registered_notifiers_.begin();
+  auto requested_it = requested.begin();
+  while (registered_it != registered_notifiers_.end() || requested_it != requested.end()) {
+    if (requested_it == requested.end() ||
+      (registered_it != registered_notifiers_.end() && *registered_it < *requested_it))
+    {
+      unregister_notifier(epoll_fd_, *registered_it);
+      ++registered_it;
+    } else if (registered_it == registered_notifiers_.end() || *requested_it < *registered_it) {
+      epoll_event event;
+      // edge-triggered, so that the descriptor isn't read and every epoll wait set
+      // polling the notifier is woken up by each write
+      event.events = EPOLLIN | EPOLLET;
+      event.data.ptr = *requested_it;
+      if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, (*requested_it)->get_fd(), &event) != 0) {
+        // registered are the requested ones before this one and the previous ones left,
+        // unregister them all to start over on the next wait
+        for (auto it = requested.begin(); it != requested_it; ++it) {
+          unregister_notifier(epoll_fd_, *it);
+        }
+        for (auto it = registered_it; it != registered_notifiers_.end(); ++it) {
+          unregister_notifier(epoll_fd_, *it);
+        }
+        registered_notifiers_.clear();
+        last_requested_notifiers_.clear();
+        RMW_SET_ERROR_MSG("failed to register wait notifier with epoll instance");
+        return RMW_RET_ERROR;
+      }
+      (*requested_it)->add_poller();
+      ++requested_it;
+    } else {
+      ++registered_it;
+      ++requested_it;
+    }
+  }
+#endif
+  registered_notifiers_.swap(requested);
+  last_requested_notifiers_.swap(requested_notifiers);
+  return RMW_RET_OK;
+}
+
+rmw_ret_t
+ConnextEpollWaitSet::wait(int timeout_ms)
+{
+#ifdef __linux__
+  epoll_event events[max_epoll_events];
+  int event_count = epoll_wait(epoll_fd_, events, max_epoll_events, timeout_ms);
+  if (event_count < 0) {
+    if (errno == EINTR) {
+      return RMW_RET_OK;
+    }
+    RMW_SET_ERROR_MSG("failed to wait on epoll instance");
+    return RMW_RET_ERROR;
+  }
+  // the caller checks the entities, which notifiers were reported doesn't matter
+  return event_count == 0 ? RMW_RET_TIMEOUT : RMW_RET_OK;
+#else
+  (void) timeout_ms;
+  RMW_SET_ERROR_MSG("the epoll wait backend is only available on Linux");
+  return RMW_RET_ERROR;
+#endif
+}
+
+void
+ConnextEpollWaitSet::remove_notifier(ConnextWaitNotifier * notifier)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = std::lower_bound(registered_notifiers_.begin(), registered_notifiers_.end(), notifier);
+  if (it == registered_notifiers_.end() || *it != notifier) {
+    return;
+  }
+  unregister_notifier(epoll_fd_, notifier);
+  registered_notifiers_.erase(it);
+  // a new notifier may be allocated at the same address
+  last_requested_notifiers_.clear();
+}
+
+void
+ConnextEpollWaitSet::remove_all_notifiers()
+{
+  for (ConnextWaitNotifier * notifier : registered_notifiers_) {
+    unregister_notifier(epoll_fd_, notifier);
+  }
+  registered_notifiers_.clear();
+  last_requested_notifiers_.clear();
+}
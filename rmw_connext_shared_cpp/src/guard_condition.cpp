@@ -12,8 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "rmw_connext_shared_cpp/connext_guard_condition.hpp"
 #include "rmw_connext_shared_cpp/guard_condition.hpp"
-#include "rmw_connext_shared_cpp/ndds_include.hpp"
 
 #include "rmw/allocators.h"
 #include "rmw/error_handling.h"
@@ -34,20 +34,29 @@ create_guard_condition(const char * implementation_identifier, rmw_context_t * c
     RMW_SET_ERROR_MSG("failed to allocate guard condition");
     return NULL;
   }
-  // Allocate memory for the DDSGuardCondition object.
-  DDS::GuardCondition * dds_guard_condition = nullptr;
-  void * buf = rmw_allocate(sizeof(DDS::GuardCondition));
+  // Allocate memory for the ConnextGuardCondition object.
+  ConnextGuardCondition * connext_guard_condition = nullptr;
+  void * buf = rmw_allocate(sizeof(ConnextGuardCondition));
   if (!buf) {
     RMW_SET_ERROR_MSG("failed to allocate memory");
     goto fail;
   }
-  // Use a placement new to construct the DDS::GuardCondition in the preallocated buffer.
-  RMW_TRY_PLACEMENT_NEW(dds_guard_condition, buf, goto fail, DDS::GuardCondition, )
-  buf = nullptr;  // Only free the dds_guard_condition pointer; don't need the buf pointer anymore.
+  // Use a placement new to construct the ConnextGuardCondition in the preallocated buffer.
+  RMW_TRY_PLACEMENT_NEW(connext_guard_condition, buf, goto fail, ConnextGuardCondition, )
+  buf = nullptr;  // Only free the guard condition pointer; don't need the buf pointer anymore.
+  if (!connext_guard_condition->init()) {
+    // error string was set within the function
+    goto fail;
+  }
   guard_condition->implementation_identifier = implementation_identifier;
-  guard_condition->data = dds_guard_condition;
+  guard_condition->data = connext_guard_condition;
   return guard_condition;
 fail:
+  if (connext_guard_condition) {
+    RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+      connext_guard_condition->~ConnextGuardCondition(), ConnextGuardCondition)
+    rmw_free(connext_guard_condition);
+  }
   if (guard_condition) {
     rmw_guard_condition_free(guard_condition);
   }
@@ -72,13 +81,10 @@ destroy_guard_condition(
     return RMW_RET_ERROR)
 
   auto result = RMW_RET_OK;
-#if defined __clang__
-  using DDS::GuardCondition;
-#endif
   RMW_TRY_DESTRUCTOR(
-    static_cast<DDS::GuardCondition *>(guard_condition->data)
-    ->DDS::GuardCondition::~GuardCondition(),
-    DDS::GuardCondition, result = RMW_RET_ERROR)
+    static_cast<ConnextGuardCondition *>(guard_condition->data)
+    ->~ConnextGuardCondition(),
+    ConnextGuardCondition, result = RMW_RET_ERROR)
   rmw_free(guard_condition->data);
   rmw_guard_condition_free(guard_condition);
   return result;
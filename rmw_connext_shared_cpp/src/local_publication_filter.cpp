@@ -0,0 +1,116 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+
+#include "rmw_connext_shared_cpp/local_publication_filter.hpp"
+
+void
+LocalPublicationFilter::add_reader(
+  DDS::DomainParticipant * participant,
+  const std::string & topic_name,
+  bool ignore_local_publications,
+  bool ignore_in_participant)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  TopicEntities & topic = topics_[topic_name];
+  ++topic.readers;
+  if (!ignore_local_publications) {
+    ++topic.readers_wanting_local;
+  } else if (ignore_in_participant) {
+    ++topic.readers_ignoring_in_participant;
+    ignore_local_writers(participant, topic);
+  }
+}
+
+void
+LocalPublicationFilter::remove_reader(
+  const std::string & topic_name,
+  bool ignore_local_publications,
+  bool ignore_in_participant)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = topics_.find(topic_name);
+  if (it == topics_.end()) {
+    return;
+  }
+  TopicEntities & topic = it->second;
+  if (!ignore_local_publications) {
+    if (topic.readers_wanting_local > 0) {
+      --topic.readers_wanting_local;
+    }
+  } else if (ignore_in_participant && topic.readers_ignoring_in_participant > 0) {
+    --topic.readers_ignoring_in_participant;
+  }
+  if (topic.readers > 0) {
+    --topic.readers;
+  }
+  if (topic.readers == 0 && topic.writers.empty()) {
+    topics_.erase(it);
+  }
+}
+
+void
+LocalPublicationFilter::add_writer(
+  DDS::DomainParticipant * participant,
+  const std::string & topic_name,
+  const DDS::InstanceHandle_t & publication_handle)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  TopicEntities & topic = topics_[topic_name];
+  topic.writers.push_back({publication_handle, false});
+  ignore_local_writers(participant, topic);
+}
+
+void
+LocalPublicationFilter::remove_writer(
+  const std::string & topic_name,
+  const DDS::InstanceHandle_t & publication_handle)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = topics_.find(topic_name);
+  if (it == topics_.end()) {
+    return;
+  }
+  TopicEntities & topic = it->second;
+  auto writer_it = std::find_if(
+    topic.writers.begin(), topic.writers.end(),
+    [&publication_handle](const LocalWriter & writer) {
+      return DDS_InstanceHandle_equals(&writer.publication_handle, &publication_handle);
+    });
+  if (writer_it != topic.writers.end()) {
+    topic.writers.erase(writer_it);
+  }
+  if (topic.readers == 0 && topic.writers.empty()) {
+    topics_.erase(it);
+  }
+}
+
+void
+LocalPublicationFilter::ignore_local_writers(
+  DDS::DomainParticipant * participant,
+  TopicEntities & topic)
+{
+  if (topic.readers_ignoring_in_participant == 0 || topic.readers_wanting_local > 0) {
+    return;
+  }
+  for (LocalWriter & writer : topic.writers) {
+    // a writer which couldn't be ignored is still dropped by the readers
+    if (!writer.ignored &&
+      participant->ignore_publication(writer.publication_handle) == DDS::RETCODE_OK)
+    {
+      writer.ignored = true;
+    }
+  }
+}
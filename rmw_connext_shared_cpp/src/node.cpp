@@ -491,6 +491,8 @@ destroy_node(const char * implementation_identifier, rmw_node_t * node)
     node_info->graph_guard_condition = nullptr;
   }
 
+  RMW_TRY_DESTRUCTOR(
+    node_info->~ConnextNodeInfo(), ConnextNodeInfo, return RMW_RET_ERROR)
   rmw_free(node_info);
   node->data = nullptr;
   rmw_free(const_cast<char *>(node->name));
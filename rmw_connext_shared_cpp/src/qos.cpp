@@ -156,6 +156,17 @@ get_datareader_qos(
   DDS::DomainParticipant * participant,
   const rmw_qos_profile_t & qos_profile,
   DDS::DataReaderQos & datareader_qos)
+{
+  return get_datareader_qos(
+    participant, qos_profile, ConnextDataReaderQosOptions(), datareader_qos);
+}
+
+bool
+get_datareader_qos(
+  DDS::DomainParticipant * participant,
+  const rmw_qos_profile_t & qos_profile,
+  const ConnextDataReaderQosOptions & options,
+  DDS::DataReaderQos & datareader_qos)
 {
   DDS::ReturnCode_t status = participant->get_default_datareader_qos(datareader_qos);
   if (status != DDS::RETCODE_OK) {
@@ -187,6 +198,20 @@ get_datareader_qos(
     return false;
   }
 
+  if (!is_time_default(options.minimum_separation)) {
+    // DDS rejects a deadline shorter than the minimum separation as inconsistent.
+    if (!is_time_default(qos_profile.deadline) &&
+      (qos_profile.deadline.sec < options.minimum_separation.sec ||
+      (qos_profile.deadline.sec == options.minimum_separation.sec &&
+      qos_profile.deadline.nsec < options.minimum_separation.nsec)))
+    {
+      RMW_SET_ERROR_MSG("minimum separation must not be longer than the deadline");
+      return false;
+    }
+    datareader_qos.time_based_filter.minimum_separation =
+      rmw_time_to_dds(options.minimum_separation);
+  }
+
   return true;
 }
 
@@ -195,6 +220,17 @@ get_datawriter_qos(
   DDS::DomainParticipant * participant,
   const rmw_qos_profile_t & qos_profile,
   DDS::DataWriterQos & datawriter_qos)
+{
+  return get_datawriter_qos(
+    participant, qos_profile, ConnextDataWriterQosOptions(), datawriter_qos);
+}
+
+bool
+get_datawriter_qos(
+  DDS::DomainParticipant * participant,
+  const rmw_qos_profile_t & qos_profile,
+  const ConnextDataWriterQosOptions & options,
+  DDS::DataWriterQos & datawriter_qos)
 {
   DDS::ReturnCode_t status = participant->get_default_datawriter_qos(datawriter_qos);
   if (status != DDS::RETCODE_OK) {
@@ -216,9 +252,45 @@ get_datawriter_qos(
     return false;
   }
 
-  // TODO(wjwwood): conditionally use the async publish mode using a heuristic:
-  //  https://github.com/ros2/rmw_connext/issues/190
-  datawriter_qos.publish_mode.kind = DDS::ASYNCHRONOUS_PUBLISH_MODE_QOS;
+  ConnextPublishMode publish_mode = options.publish_mode;
+  if (publish_mode == ConnextPublishMode::automatic) {
+    // Connext doesn't support batching in combination with asynchronous publishing.
+    if (
+      options.batch_enable ||
+      (options.max_serialized_size > 0 &&
+      options.max_serialized_size <= connext_max_synchronous_sample_size))
+    {
+      publish_mode = ConnextPublishMode::synchronous;
+    } else {
+      publish_mode = ConnextPublishMode::asynchronous;
+    }
+  }
+  if (publish_mode == ConnextPublishMode::asynchronous && options.batch_enable) {
+    RMW_SET_ERROR_MSG("batching requires the synchronous publish mode");
+    return false;
+  }
+  // The default qos already selects the default flow controller for asynchronous writers.
+  datawriter_qos.publish_mode.kind = publish_mode == ConnextPublishMode::synchronous ?
+    DDS::SYNCHRONOUS_PUBLISH_MODE_QOS : DDS::ASYNCHRONOUS_PUBLISH_MODE_QOS;
+
+  if (options.batch_enable) {
+    if (options.batch_max_samples < 0 || options.batch_max_data_bytes < 0) {
+      RMW_SET_ERROR_MSG("batch limits must not be negative");
+      return false;
+    }
+    datawriter_qos.batch.enable = DDS::BOOLEAN_TRUE;
+    datawriter_qos.batch.max_samples = options.batch_max_samples == 0 ?
+      DDS::LENGTH_UNLIMITED : options.batch_max_samples;
+    if (options.batch_max_data_bytes != 0) {
+      datawriter_qos.batch.max_data_bytes = options.batch_max_data_bytes;
+    }
+    if (is_time_default(options.batch_max_flush_delay)) {
+      datawriter_qos.batch.max_flush_delay.sec = DDS::DURATION_INFINITE_SEC;
+      datawriter_qos.batch.max_flush_delay.nanosec = DDS::DURATION_INFINITE_NSEC;
+    } else {
+      datawriter_qos.batch.max_flush_delay = rmw_time_to_dds(options.batch_max_flush_delay);
+    }
+  }
 
   return true;
 }
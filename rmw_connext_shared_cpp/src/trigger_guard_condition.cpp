@@ -16,6 +16,7 @@
 #include "rmw/impl/cpp/macros.hpp"
 #include "rmw/types.h"
 
+#include "rmw_connext_shared_cpp/connext_guard_condition.hpp"
 #include "rmw_connext_shared_cpp/ndds_include.hpp"
 #include "rmw_connext_shared_cpp/trigger_guard_condition.hpp"
 #include "rmw_connext_shared_cpp/types.hpp"
@@ -34,14 +35,13 @@ trigger_guard_condition(
     guard_condition_handle->implementation_identifier, implementation_identifier,
     return RMW_RET_ERROR)
 
-  DDS::GuardCondition * guard_condition =
-    static_cast<DDS::GuardCondition *>(guard_condition_handle->data);
+  ConnextGuardCondition * guard_condition =
+    static_cast<ConnextGuardCondition *>(guard_condition_handle->data);
   if (!guard_condition) {
     RMW_SET_ERROR_MSG("guard condition is null");
     return RMW_RET_ERROR;
   }
-  DDS::ReturnCode_t status = guard_condition->set_trigger_value(DDS::BOOLEAN_TRUE);
-  if (status != DDS::RETCODE_OK) {
+  if (!guard_condition->trigger()) {
     RMW_SET_ERROR_MSG("failed to set trigger value");
     return RMW_RET_ERROR;
   }
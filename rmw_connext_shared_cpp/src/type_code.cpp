@@ -0,0 +1,314 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <cstdint>
+#include <limits>
+
+#include "rmw_connext_shared_cpp/type_code.hpp"
+
+namespace
+{
+
+// Size of the CDR encapsulation header preceding the serialized sample.
+constexpr size_t encapsulation_size = 4;
+// Serialized samples are limited to what a DDS_Long can express.
+constexpr size_t max_sample_size = static_cast<size_t>(std::numeric_limits<DDS_Long>::max());
+
+bool
+add(size_t & offset, size_t size)
+{
+  if (size > max_sample_size - offset) {
+    return false;
+  }
+  offset += size;
+  return true;
+}
+
+bool
+align(size_t & offset, size_t alignment)
+{
+  return add(offset, (alignment - offset % alignment) % alignment);
+}
+
+bool
+multiply(size_t & size, size_t count)
+{
+  if (count != 0 && size > max_sample_size / count) {
+    return false;
+  }
+  size *= count;
+  return true;
+}
+
+// Return the serialized size of a primitive kind or 0 if the kind isn't a primitive.
+size_t
+primitive_size(DDS_TCKind kind)
+{
+  switch (kind) {
+    case DDS_TK_BOOLEAN:
+    case DDS_TK_CHAR:
+    case DDS_TK_OCTET:
+      return 1;
+    case DDS_TK_SHORT:
+    case DDS_TK_USHORT:
+      return 2;
+    case DDS_TK_LONG:
+    case DDS_TK_ULONG:
+    case DDS_TK_FLOAT:
+    case DDS_TK_ENUM:
+    case DDS_TK_WCHAR:
+      return 4;
+    case DDS_TK_LONGLONG:
+    case DDS_TK_ULONGLONG:
+    case DDS_TK_DOUBLE:
+      return 8;
+    case DDS_TK_LONGDOUBLE:
+      return 16;
+    default:
+      return 0;
+  }
+}
+
+bool
+add_max_size(const DDS_TypeCode * type_code, size_t & offset);
+
+// Add count consecutive elements of the given type.
+bool
+add_elements(const DDS_TypeCode * element_type, size_t count, size_t & offset)
+{
+  DDS_ExceptionCode_t ex = DDS_NO_EXCEPTION_CODE;
+  const DDS_TCKind kind = element_type->kind(ex);
+  if (ex != DDS_NO_EXCEPTION_CODE) {
+    return false;
+  }
+  if (count == 0) {
+    return true;
+  }
+  const size_t size = primitive_size(kind);
+  if (size != 0) {
+    size_t total = size;
+    return align(offset, size < 8 ? size : 8) && multiply(total, count) && add(offset, total);
+  }
+  // The padding of complex elements depends on their position,
+  // assume the worst case alignment in front of every element.
+  size_t element_size = 0;
+  if (!add_max_size(element_type, element_size) || !add(element_size, 7)) {
+    return false;
+  }
+  return multiply(element_size, count) && add(offset, element_size);
+}
+
+bool
+add_max_size(const DDS_TypeCode * type_code, size_t & offset)
+{
+  if (!type_code) {
+    return false;
+  }
+  DDS_ExceptionCode_t ex = DDS_NO_EXCEPTION_CODE;
+  const DDS_TCKind kind = type_code->kind(ex);
+  if (ex != DDS_NO_EXCEPTION_CODE) {
+    return false;
+  }
+  const size_t size = primitive_size(kind);
+  if (size != 0) {
+    return align(offset, size < 8 ? size : 8) && add(offset, size);
+  }
+  switch (kind) {
+    case DDS_TK_STRING:
+    case DDS_TK_WSTRING:
+      {
+        const DDS_UnsignedLong bound = type_code->length(ex);
+        if (ex != DDS_NO_EXCEPTION_CODE || bound == 0) {
+          return false;
+        }
+        // length prefix followed by the characters and the terminating null
+        size_t characters = static_cast<size_t>(bound) + 1;
+        return align(offset, 4) && add(offset, 4) &&
+               multiply(characters, kind == DDS_TK_WSTRING ? 4 : 1) && add(offset, characters);
+      }
+    case DDS_TK_SEQUENCE:
+      {
+        const DDS_UnsignedLong bound = type_code->length(ex);
+        if (ex != DDS_NO_EXCEPTION_CODE || bound == 0) {
+          return false;
+        }
+        const DDS_TypeCode * element_type = type_code->content_type(ex);
+        if (ex != DDS_NO_EXCEPTION_CODE || !element_type) {
+          return false;
+        }
+        return align(offset, 4) && add(offset, 4) &&
+               add_elements(element_type, bound, offset);
+      }
+    case DDS_TK_ARRAY:
+      {
+        const DDS_UnsignedLong count = type_code->element_count(ex);
+        if (ex != DDS_NO_EXCEPTION_CODE) {
+          return false;
+        }
+        const DDS_TypeCode * element_type = type_code->content_type(ex);
+        if (ex != DDS_NO_EXCEPTION_CODE || !element_type) {
+          return false;
+        }
+        return add_elements(element_type, count, offset);
+      }
+    case DDS_TK_ALIAS:
+      {
+        const DDS_TypeCode * content_type = type_code->content_type(ex);
+        if (ex != DDS_NO_EXCEPTION_CODE) {
+          return false;
+        }
+        return add_max_size(content_type, offset);
+      }
+    case DDS_TK_STRUCT:
+      {
+        const DDS_UnsignedLong member_count = type_code->member_count(ex);
+        if (ex != DDS_NO_EXCEPTION_CODE) {
+          return false;
+        }
+        for (DDS_UnsignedLong i = 0; i < member_count; ++i) {
+          const DDS_TypeCode * member_type = type_code->member_type(i, ex);
+          if (ex != DDS_NO_EXCEPTION_CODE || !add_max_size(member_type, offset)) {
+            return false;
+          }
+        }
+        return true;
+      }
+    default:
+      // unions, value types and sparse types are not generated for ROS messages
+      return false;
+  }
+}
+
+// Return the alignment of the C type of a primitive kind or 0 if it has none in a plain type.
+size_t
+primitive_alignment(DDS_TCKind kind)
+{
+  switch (kind) {
+    case DDS_TK_BOOLEAN:
+    case DDS_TK_CHAR:
+    case DDS_TK_OCTET:
+      return 1;
+    case DDS_TK_SHORT:
+    case DDS_TK_USHORT:
+      return alignof(int16_t);
+    case DDS_TK_LONG:
+    case DDS_TK_ULONG:
+      return alignof(int32_t);
+    case DDS_TK_FLOAT:
+      return alignof(float);
+    case DDS_TK_LONGLONG:
+    case DDS_TK_ULONGLONG:
+      return alignof(int64_t);
+    case DDS_TK_DOUBLE:
+      return alignof(double);
+    case DDS_TK_LONGDOUBLE:
+      return alignof(long double);
+    default:
+      return 0;
+  }
+}
+
+bool
+get_layout(const DDS_TypeCode * type_code, size_t & size, size_t & alignment)
+{
+  if (!type_code) {
+    return false;
+  }
+  DDS_ExceptionCode_t ex = DDS_NO_EXCEPTION_CODE;
+  const DDS_TCKind kind = type_code->kind(ex);
+  if (ex != DDS_NO_EXCEPTION_CODE) {
+    return false;
+  }
+  const size_t primitive_align = primitive_alignment(kind);
+  if (primitive_align != 0) {
+    size = kind == DDS_TK_LONGDOUBLE ? sizeof(long double) : primitive_size(kind);
+    alignment = primitive_align;
+    return true;
+  }
+  switch (kind) {
+    case DDS_TK_ARRAY:
+      {
+        const DDS_UnsignedLong count = type_code->element_count(ex);
+        if (ex != DDS_NO_EXCEPTION_CODE) {
+          return false;
+        }
+        size_t element_size = 0;
+        if (!get_layout(type_code->content_type(ex), element_size, alignment)) {
+          return false;
+        }
+        size = element_size;
+        return ex == DDS_NO_EXCEPTION_CODE && multiply(size, count);
+      }
+    case DDS_TK_ALIAS:
+      {
+        const DDS_TypeCode * content_type = type_code->content_type(ex);
+        return ex == DDS_NO_EXCEPTION_CODE && get_layout(content_type, size, alignment);
+      }
+    case DDS_TK_STRUCT:
+      {
+        const DDS_UnsignedLong member_count = type_code->member_count(ex);
+        if (ex != DDS_NO_EXCEPTION_CODE || member_count == 0) {
+          return false;
+        }
+        size_t offset = 0;
+        alignment = 1;
+        for (DDS_UnsignedLong i = 0; i < member_count; ++i) {
+          const DDS_TypeCode * member_type = type_code->member_type(i, ex);
+          size_t member_size = 0;
+          size_t member_alignment = 0;
+          if (
+            ex != DDS_NO_EXCEPTION_CODE ||
+            !get_layout(member_type, member_size, member_alignment) ||
+            !align(offset, member_alignment) || !add(offset, member_size))
+          {
+            return false;
+          }
+          if (member_alignment > alignment) {
+            alignment = member_alignment;
+          }
+        }
+        size = offset;
+        return align(size, alignment);
+      }
+    default:
+      // strings and sequences own memory, everything else isn't generated for ROS messages
+      return false;
+  }
+}
+
+}  // namespace
+
+bool
+get_plain_type_layout(const DDS_TypeCode * type_code, size_t & size, size_t & alignment)
+{
+  size_t layout_size = 0;
+  size_t layout_alignment = 0;
+  if (!get_layout(type_code, layout_size, layout_alignment)) {
+    return false;
+  }
+  size = layout_size;
+  alignment = layout_alignment;
+  return true;
+}
+
+bool
+get_serialized_sample_max_size(const DDS_TypeCode * type_code, size_t & max_size)
+{
+  size_t offset = 0;
+  if (!add_max_size(type_code, offset) || !add(offset, encapsulation_size)) {
+    return false;
+  }
+  max_size = offset;
+  return true;
+}
@@ -0,0 +1,115 @@
+// Copyright 2020 Open Source Robotics Foundation, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
+#include <cerrno>
+#include <cstdint>
+
+#include "rmw/allocators.h"
+#include "rmw/error_handling.h"
+#include "rmw/impl/cpp/macros.hpp"
+
+#include "rmw_connext_shared_cpp/wait_notifier.hpp"
+#include "rmw_connext_shared_cpp/wait_set.hpp"
+
+ConnextWaitNotifier::ConnextWaitNotifier()
+: fd_(-1),
+  pollers_(0)
+{}
+
+ConnextWaitNotifier::~ConnextWaitNotifier()
+{
+  if (pollers_ > 0) {
+    remove_from_epoll_wait_sets(this);
+  }
+#ifdef __linux__
+  if (fd_ >= 0) {
+    close(fd_);
+  }
+#endif
+}
+
+bool
+ConnextWaitNotifier::init()
+{
+#ifdef __linux__
+  fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  if (fd_ < 0) {
+    RMW_SET_ERROR_MSG("failed to create eventfd of wait notifier");
+    return false;
+  }
+#endif
+  return true;
+}
+
+void
+ConnextWaitNotifier::notify()
+{
+#ifdef __linux__
+  if (pollers_ == 0) {
+    return;
+  }
+  uint64_t value = 1;
+  ssize_t written;
+  do {
+    written = write(fd_, &value, sizeof(value));
+  } while (written < 0 && errno == EINTR);
+  // EAGAIN means the never read counter is about to overflow after 2^64 - 2 writes.
+#endif
+}
+
+void
+ConnextWaitNotifier::add_poller()
+{
+  ++pollers_;
+}
+
+void
+ConnextWaitNotifier::remove_poller()
+{
+  --pollers_;
+}
+
+ConnextWaitNotifier *
+create_wait_notifier()
+{
+  ConnextWaitNotifier * notifier = nullptr;
+  void * buf = rmw_allocate(sizeof(ConnextWaitNotifier));
+  if (!buf) {
+    RMW_SET_ERROR_MSG("failed to allocate memory for wait notifier");
+    return nullptr;
+  }
+  RMW_TRY_PLACEMENT_NEW(notifier, buf, rmw_free(buf); return nullptr, ConnextWaitNotifier, )
+  if (!notifier->init()) {
+    // error string was set within the function
+    destroy_wait_notifier(notifier);
+    return nullptr;
+  }
+  return notifier;
+}
+
+void
+destroy_wait_notifier(ConnextWaitNotifier * notifier)
+{
+  if (!notifier) {
+    return;
+  }
+  RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+    notifier->~ConnextWaitNotifier(), ConnextWaitNotifier)
+  rmw_free(notifier);
+}
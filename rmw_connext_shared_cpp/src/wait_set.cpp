@@ -12,8 +12,104 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "rcutils/logging_macros.h"
+
+#include "rmw/error_handling.h"
+
+#include "rmw_connext_shared_cpp/epoll_wait_set.hpp"
 #include "rmw_connext_shared_cpp/shared_functions.hpp"
 
+namespace
+{
+// Every wait set, so that conditions can be detached from them before being deleted.
+struct WaitSetRegistry
+{
+  std::mutex mutex;
+  std::unordered_set<ConnextWaitSetInfo *> wait_sets;
+};
+
+WaitSetRegistry &
+get_wait_set_registry()
+{
+  static WaitSetRegistry registry;
+  return registry;
+}
+
+rmw_ret_t
+detach_condition(DDS::WaitSet * dds_wait_set, DDS::Condition * condition)
+{
+  rmw_ret_t from_dds = check_dds_ret_code(dds_wait_set->detach_condition(condition));
+  if (from_dds != RMW_RET_OK) {
+    RMW_SET_ERROR_MSG("Failed to get detach condition from wait set");
+    return from_dds;
+  }
+  return RMW_RET_OK;
+}
+
+// Detach whatever is attached to the wait set, the caller holds attached_conditions_mutex.
+rmw_ret_t
+detach_all_conditions(ConnextWaitSetInfo * wait_set_info)
+{
+  wait_set_info->attached_condition_set.clear();
+  wait_set_info->last_requested_conditions.clear();
+  wait_set_info->last_status_masks.clear();
+
+  DDS::ConditionSeq * attached_conditions = wait_set_info->attached_conditions;
+  if (wait_set_info->wait_set->get_conditions(*attached_conditions) != DDS::RETCODE_OK) {
+    RMW_SET_ERROR_MSG("Failed to get attached conditions for wait set");
+    return RMW_RET_ERROR;
+  }
+  for (DDS::Long i = 0; i < attached_conditions->length(); ++i) {
+    rmw_ret_t rmw_ret_code =
+      detach_condition(wait_set_info->wait_set, (*attached_conditions)[i]);
+    if (rmw_ret_code != RMW_RET_OK) {
+      return rmw_ret_code;
+    }
+  }
+  return RMW_RET_OK;
+}
+
+// Attach and detach conditions until the attached set equals the requested set,
+// both being sorted without duplicates.
+rmw_ret_t
+apply_attached_conditions_diff(ConnextWaitSetInfo * wait_set_info)
+{
+  DDS::WaitSet * dds_wait_set = wait_set_info->wait_set;
+  const std::vector<DDS::Condition *> & attached = wait_set_info->attached_condition_set;
+  const std::vector<DDS::Condition *> & requested = wait_set_info->requested_condition_set;
+  auto attached_it = attached.begin();
+  auto requested_it = requested.begin();
+  while (attached_it != attached.end() || requested_it != requested.end()) {
+    if (requested_it == requested.end() ||
+      (attached_it != attached.end() && *attached_it < *requested_it))
+    {
+      rmw_ret_t rmw_ret_code = detach_condition(dds_wait_set, *attached_it);
+      if (rmw_ret_code != RMW_RET_OK) {
+        return rmw_ret_code;
+      }
+      ++attached_it;
+    } else if (attached_it == attached.end() || *requested_it < *attached_it) {
+      rmw_ret_t rmw_ret_code = check_attach_condition_error(
+        dds_wait_set->attach_condition(*requested_it));
+      if (rmw_ret_code != RMW_RET_OK) {
+        return rmw_ret_code;
+      }
+      ++requested_it;
+    } else {
+      ++attached_it;
+      ++requested_it;
+    }
+  }
+  return RMW_RET_OK;
+}
+}  // namespace
+
 rmw_wait_set_t *
 create_wait_set(
   const char * implementation_identifier,
@@ -39,12 +135,12 @@ create_wait_set(
   }
   wait_set->implementation_identifier = implementation_identifier;
   wait_set->data = rmw_allocate(sizeof(ConnextWaitSetInfo));
-  wait_set_info = static_cast<ConnextWaitSetInfo *>(wait_set->data);
-
-  if (!wait_set_info) {
+  if (!wait_set->data) {
     RMW_SET_ERROR_MSG("failed to allocate wait set");
     goto fail;
   }
+  RMW_TRY_PLACEMENT_NEW(
+    wait_set_info, wait_set->data, goto fail, ConnextWaitSetInfo, )
 
   wait_set_info->wait_set = static_cast<DDS::WaitSet *>(rmw_allocate(sizeof(DDS::WaitSet)));
   if (!wait_set_info->wait_set) {
@@ -92,6 +188,24 @@ create_wait_set(
       DDS::ConditionSeq, )
   }
 
+  try {
+    wait_set_info->requested_conditions.reserve(max_conditions);
+    wait_set_info->last_requested_conditions.reserve(max_conditions);
+    wait_set_info->attached_condition_set.reserve(max_conditions);
+    wait_set_info->requested_condition_set.reserve(max_conditions);
+    wait_set_info->condition_slots.reserve(max_conditions);
+    wait_set_info->request_slots.reserve(max_conditions);
+    wait_set_info->triggered_slots.reserve(max_conditions);
+    wait_set_info->status_masks.reserve(max_conditions);
+    wait_set_info->last_status_masks.reserve(max_conditions);
+    WaitSetRegistry & registry = get_wait_set_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.wait_sets.insert(wait_set_info);
+  } catch (const std::exception &) {
+    RMW_SET_ERROR_MSG("failed to allocate wait set");
+    goto fail;
+  }
+
   return wait_set;
 
 fail:
@@ -121,6 +235,8 @@ fail:
         wait_set_info->wait_set->DDS::WaitSet::~WaitSet(), DDS::WaitSet)
       rmw_free(wait_set_info->wait_set);
     }
+    RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+      wait_set_info->~ConnextWaitSetInfo(), ConnextWaitSetInfo)
     wait_set_info = nullptr;
   }
   if (wait_set) {
@@ -147,6 +263,26 @@ destroy_wait_set(const char * implementation_identifier, rmw_wait_set_t * wait_s
   auto result = RMW_RET_OK;
   ConnextWaitSetInfo * wait_set_info = static_cast<ConnextWaitSetInfo *>(wait_set->data);
 
+  {
+    WaitSetRegistry & registry = get_wait_set_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.wait_sets.erase(wait_set_info);
+    if (wait_set_info->epoll_wait_set) {
+      RMW_TRY_DESTRUCTOR(
+        wait_set_info->epoll_wait_set->~ConnextEpollWaitSet(), ConnextEpollWaitSet,
+        result = RMW_RET_ERROR)
+      rmw_free(wait_set_info->epoll_wait_set);
+      wait_set_info->epoll_wait_set = nullptr;
+    }
+  }
+  // conditions stay attached after the last wait
+  if (wait_set_info->wait_set && wait_set_info->attached_conditions) {
+    std::lock_guard<std::mutex> lock(wait_set_info->attached_conditions_mutex);
+    if (detach_all_conditions(wait_set_info) != RMW_RET_OK) {
+      result = RMW_RET_ERROR;
+    }
+  }
+
   // Explicitly call destructor since the "placement new" was used
   if (wait_set_info->active_conditions) {
 #if defined __clang__
@@ -174,6 +310,8 @@ destroy_wait_set(const char * implementation_identifier, rmw_wait_set_t * wait_s
       wait_set_info->wait_set->DDS::WaitSet::~WaitSet(), WaitSet, result = RMW_RET_ERROR)
     rmw_free(wait_set_info->wait_set);
   }
+  RMW_TRY_DESTRUCTOR(
+    wait_set_info->~ConnextWaitSetInfo(), ConnextWaitSetInfo, result = RMW_RET_ERROR)
   wait_set_info = nullptr;
   if (wait_set->data) {
     rmw_free(wait_set->data);
@@ -183,3 +321,152 @@ destroy_wait_set(const char * implementation_identifier, rmw_wait_set_t * wait_s
   }
   return result;
 }
+
+rmw_ret_t
+update_attached_conditions(ConnextWaitSetInfo * wait_set_info)
+{
+  std::lock_guard<std::mutex> lock(wait_set_info->attached_conditions_mutex);
+  std::vector<DDS::Condition *> & requested = wait_set_info->requested_conditions;
+  std::vector<DDS::Condition *> & last_requested = wait_set_info->last_requested_conditions;
+  // executors usually wait on the same entities in the same order over and over
+  if (requested == last_requested) {
+    return RMW_RET_OK;
+  }
+
+  std::vector<DDS::Condition *> & requested_set = wait_set_info->requested_condition_set;
+  requested_set.assign(requested.begin(), requested.end());
+  std::sort(requested_set.begin(), requested_set.end());
+  requested_set.erase(std::unique(requested_set.begin(), requested_set.end()), requested_set.end());
+
+  rmw_ret_t rmw_ret_code = apply_attached_conditions_diff(wait_set_info);
+  if (rmw_ret_code != RMW_RET_OK) {
+    // start over from an empty wait set on the next wait
+    detach_all_conditions(wait_set_info);
+    return rmw_ret_code;
+  }
+  wait_set_info->attached_condition_set.swap(requested_set);
+
+  // duplicate requests share the slot of the first one
+  std::unordered_map<DDS::Condition *, size_t> & condition_slots = wait_set_info->condition_slots;
+  condition_slots.clear();
+  wait_set_info->request_slots.resize(requested.size());
+  for (size_t i = 0; i < requested.size(); ++i) {
+    wait_set_info->request_slots[i] = condition_slots.emplace(requested[i], i).first->second;
+  }
+  wait_set_info->triggered_slots.assign(requested.size(), 0);
+
+  last_requested.swap(requested);
+  return RMW_RET_OK;
+}
+
+void
+mark_triggered_conditions(ConnextWaitSetInfo * wait_set_info)
+{
+  std::vector<uint8_t> & triggered_slots = wait_set_info->triggered_slots;
+  std::fill(triggered_slots.begin(), triggered_slots.end(), 0);
+  const std::unordered_map<DDS::Condition *, size_t> & condition_slots =
+    wait_set_info->condition_slots;
+  const DDS::ConditionSeq & active_conditions = *wait_set_info->active_conditions;
+  for (DDS::Long i = 0; i < active_conditions.length(); ++i) {
+    auto it = condition_slots.find(active_conditions[i]);
+    if (it != condition_slots.end()) {
+      triggered_slots[it->second] = 1;
+    }
+  }
+}
+
+void
+detach_from_wait_sets(DDS::Condition * condition)
+{
+  WaitSetRegistry & registry = get_wait_set_registry();
+  std::lock_guard<std::mutex> registry_lock(registry.mutex);
+  for (ConnextWaitSetInfo * wait_set_info : registry.wait_sets) {
+    std::lock_guard<std::mutex> lock(wait_set_info->attached_conditions_mutex);
+    std::vector<DDS::Condition *> & attached = wait_set_info->attached_condition_set;
+    auto it = std::lower_bound(attached.begin(), attached.end(), condition);
+    if (it == attached.end() || *it != condition) {
+      continue;
+    }
+    if (wait_set_info->wait_set->detach_condition(condition) != DDS::RETCODE_OK) {
+      RCUTILS_LOG_ERROR_NAMED(
+        "rmw_connext_shared_cpp", "failed to detach condition from wait set");
+    }
+    attached.erase(it);
+    // a new condition may be allocated at the same address
+    wait_set_info->last_requested_conditions.clear();
+    wait_set_info->last_status_masks.clear();
+  }
+}
+
+rmw_ret_t
+set_wait_set_epoll_backend(
+  const char * implementation_identifier,
+  rmw_wait_set_t * wait_set,
+  bool use_epoll)
+{
+  if (!wait_set) {
+    RMW_SET_ERROR_MSG("wait set handle is null");
+    return RMW_RET_INVALID_ARGUMENT;
+  }
+  RMW_CHECK_TYPE_IDENTIFIERS_MATCH(
+    wait set handle,
+    wait_set->implementation_identifier, implementation_identifier,
+    return RMW_RET_ERROR)
+  auto wait_set_info = static_cast<ConnextWaitSetInfo *>(wait_set->data);
+  if (!wait_set_info) {
+    RMW_SET_ERROR_MSG("WaitSet implementation struct is null");
+    return RMW_RET_ERROR;
+  }
+#ifndef __linux__
+  if (use_epoll) {
+    RMW_SET_ERROR_MSG("the epoll wait backend is only available on Linux");
+    return RMW_RET_UNSUPPORTED;
+  }
+#endif
+  if (use_epoll == (wait_set_info->epoll_wait_set != nullptr)) {
+    return RMW_RET_OK;
+  }
+
+  // destroyed notifiers look for the epoll wait set through the registry
+  WaitSetRegistry & registry = get_wait_set_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  if (!use_epoll) {
+    auto result = RMW_RET_OK;
+    RMW_TRY_DESTRUCTOR(
+      wait_set_info->epoll_wait_set->~ConnextEpollWaitSet(), ConnextEpollWaitSet,
+      result = RMW_RET_ERROR)
+    rmw_free(wait_set_info->epoll_wait_set);
+    wait_set_info->epoll_wait_set = nullptr;
+    return result;
+  }
+
+  ConnextEpollWaitSet * epoll_wait_set = nullptr;
+  void * buf = rmw_allocate(sizeof(ConnextEpollWaitSet));
+  if (!buf) {
+    RMW_SET_ERROR_MSG("failed to allocate memory for epoll wait set");
+    return RMW_RET_BAD_ALLOC;
+  }
+  RMW_TRY_PLACEMENT_NEW(
+    epoll_wait_set, buf, rmw_free(buf); return RMW_RET_ERROR, ConnextEpollWaitSet, )
+  if (!epoll_wait_set->init()) {
+    // error string was set within the function
+    RMW_TRY_DESTRUCTOR_FROM_WITHIN_FAILURE(
+      epoll_wait_set->~ConnextEpollWaitSet(), ConnextEpollWaitSet)
+    rmw_free(epoll_wait_set);
+    return RMW_RET_ERROR;
+  }
+  wait_set_info->epoll_wait_set = epoll_wait_set;
+  return RMW_RET_OK;
+}
+
+void
+remove_from_epoll_wait_sets(ConnextWaitNotifier * notifier)
+{
+  WaitSetRegistry & registry = get_wait_set_registry();
+  std::lock_guard<std::mutex> lock(registry.mutex);
+  for (ConnextWaitSetInfo * wait_set_info : registry.wait_sets) {
+    if (wait_set_info->epoll_wait_set) {
+      wait_set_info->epoll_wait_set->remove_notifier(notifier);
+    }
+  }
+}